@@ -1,7 +1,45 @@
 import re
 import os
+import struct
+import zlib
 import argparse
 
+# Archive format read by asset_manager.c (all little-endian):
+#   header: magic "BMPK", uint16 version, uint16 asset count
+#   table:  per asset uint16 id, width, height, frame count, frame size,
+#           encoding, uint32 offset, length and CRC-32 of its data
+#   data:   raw frames back to back, or for PackBits assets frame count + 1
+#           uint32 frame offsets (relative to the asset) then coded frames
+ARCHIVE_MAGIC = b'BMPK'
+ARCHIVE_VERSION = 2
+ARCHIVE_HEADER = struct.Struct('<4sHH')
+ARCHIVE_ENTRY = struct.Struct('<HHHHHHIII')
+ENCODING_RAW = 0
+ENCODING_PACKBITS = 1
+ARCHIVE_MAX_IDS = 32
+ARCHIVE_MAX_FRAME_SIZE = 2048
+
+# Known assets: name -> (id, width, height). Ids match AssetId in
+# asset_manager.h; new assets can be added with --asset.
+KNOWN_ASSETS = {
+    'map':                   (0, 128, 128),
+    'character_run_left':    (1, 13, 17),
+    'character_run_right':   (2, 13, 17),
+    'character_jump':        (3, 13, 17),
+    'character_double_jump': (4, 13, 17),
+    'cursor':                (5, 20, 30),
+    'optionBackground':      (6, 128, 128),
+    'loading_screen':        (7, 128, 128),
+    'wifiloading':           (8, 128, 128),
+    'connected':             (9, 128, 128),
+    'funcgenerator':         (10, 128, 128),
+    'oscilloscope':          (11, 128, 128),
+    'componentpurpose':      (12, 128, 128),
+    'pinpurpose':            (13, 128, 128),
+    'servoarm':              (14, 128, 128),
+    'electronichelper':      (15, 128, 128),
+}
+
 def extract_arrays_from_header(header_file):
     """Extract bitmap arrays from a C/C++ header file."""
     with open(header_file, 'r') as f:
@@ -127,29 +165,322 @@ def save_frames_to_binary(array_name, frames, output_dir):
     
     print(f"Saved all frames to {all_frames_file} ({sum(len(frame) for frame in frames)} bytes)")
 
+def asset_name(path, array_name=None):
+    """Asset name from an array name or file name, e.g. mapFrames_all.bin -> map."""
+    base = array_name or os.path.splitext(os.path.basename(path))[0]
+    return re.sub(r'Frames(_all)?$', '', base)
+
+def load_asset(path, assets):
+    """Read one asset's frames from a C header or a *Frames_all.bin file.
+
+    Returns (name, id, width, height, frames)."""
+    if path.endswith('.h'):
+        array_name, frames = extract_arrays_from_header(path)
+        name = asset_name(path, array_name)
+        with open(path, 'r') as f:
+            content = f.read()
+        # Headers from image_bitmap_generator.py carry their size
+        width_match = re.search(r'#define\s+\w+_WIDTH\s+(\d+)', content)
+        height_match = re.search(r'#define\s+\w+_HEIGHT\s+(\d+)', content)
+    else:
+        name = asset_name(path)
+        frames = None
+        width_match = height_match = None
+
+    if name not in assets:
+        raise ValueError(f"Unknown asset '{name}' ({path}), add it with --asset {name}:ID:WxH")
+    asset_id, width, height = assets[name]
+    if width_match and height_match:
+        width, height = int(width_match.group(1)), int(height_match.group(1))
+    frame_size = (width + 7) // 8 * height
+
+    if frames is None:
+        with open(path, 'rb') as f:
+            data = f.read()
+        if len(data) == 0 or len(data) % frame_size:
+            raise ValueError(f"{path}: {len(data)} bytes is not a whole number of {frame_size} byte frames")
+        frames = [data[i:i + frame_size] for i in range(0, len(data), frame_size)]
+
+    for i, frame in enumerate(frames):
+        if len(frame) != frame_size:
+            raise ValueError(f"{path}: frame {i} is {len(frame)} bytes, expected {frame_size}")
+    if frame_size > ARCHIVE_MAX_FRAME_SIZE:
+        raise ValueError(f"{path}: {frame_size} byte frames are larger than the firmware cache allows")
+
+    return name, asset_id, width, height, frames
+
+def packbits_encode(data):
+    """PackBits-code a byte string (format in Program Code/packbits.h)."""
+    out = bytearray()
+    i = 0
+    n = len(data)
+    while i < n:
+        # Runs of two or more identical bytes become a repeat chunk
+        run = 1
+        while i + run < n and run < 128 and data[i + run] == data[i]:
+            run += 1
+        if run >= 2:
+            out.append(257 - run)
+            out.append(data[i])
+            i += run
+            continue
+
+        # Otherwise literal bytes, up to the next run of three
+        start = i
+        while i < n and i - start < 128:
+            if i + 2 < n and data[i] == data[i + 1] == data[i + 2]:
+                break
+            i += 1
+        out.append(i - start - 1)
+        out += data[start:i]
+    return bytes(out)
+
+def packbits_decode(data):
+    """Inverse of packbits_encode, used to check the encoder."""
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        n = data[i] - 256 if data[i] > 127 else data[i]
+        i += 1
+        if n >= 0:
+            out += data[i:i + n + 1]
+            i += n + 1
+        elif n != -128:
+            out += bytes([data[i]]) * (1 - n)
+            i += 1
+    return bytes(out)
+
+def encode_asset(frames, compress):
+    """Asset data and encoding. PackBits is used only when it is smaller
+    overall and no frame grows, so a coded frame never outsizes its cache slot."""
+    raw = b''.join(frames)
+    if not compress:
+        return raw, ENCODING_RAW
+
+    coded = [packbits_encode(frame) for frame in frames]
+    for frame, code in zip(frames, coded):
+        assert packbits_decode(code) == frame
+    offsets = [4 * (len(frames) + 1)]
+    for code in coded:
+        offsets.append(offsets[-1] + len(code))
+    data = struct.pack(f'<{len(offsets)}I', *offsets) + b''.join(coded)
+
+    if len(data) >= len(raw) or any(len(code) > len(frame) for frame, code in zip(frames, coded)):
+        return raw, ENCODING_RAW
+    return data, ENCODING_PACKBITS
+
+def write_archive(assets, output_path, compress=False):
+    """Pack (name, id, width, height, frames) tuples into one archive file."""
+    ids = [asset[1] for asset in assets]
+    if len(set(ids)) != len(ids):
+        raise ValueError("Two inputs map to the same asset id")
+
+    offset = ARCHIVE_HEADER.size + ARCHIVE_ENTRY.size * len(assets)
+    table = b''
+    data = b''
+    raw_total = 0
+    for name, asset_id, width, height, frames in assets:
+        asset_data, encoding = encode_asset(frames, compress)
+        raw_size = sum(len(frame) for frame in frames)
+        checksum = zlib.crc32(asset_data) & 0xFFFFFFFF
+        table += ARCHIVE_ENTRY.pack(asset_id, width, height, len(frames), len(frames[0]),
+                                    encoding, offset, len(asset_data), checksum)
+        data += asset_data
+        kind = 'packbits' if encoding == ENCODING_PACKBITS else 'raw'
+        print(f"  {name}: id {asset_id}, {width}x{height}, {len(frames)} frames, "
+              f"{raw_size} -> {len(asset_data)} bytes {kind} ({len(asset_data) / raw_size:.1%}) at offset {offset}")
+        offset += len(asset_data)
+        raw_total += raw_size
+
+    with open(output_path, 'wb') as f:
+        f.write(ARCHIVE_HEADER.pack(ARCHIVE_MAGIC, ARCHIVE_VERSION, len(assets)))
+        f.write(table)
+        f.write(data)
+
+    print(f"Saved archive {output_path} ({offset} bytes, {len(assets)} assets, "
+          f"frame data {len(data)} of {raw_total} bytes = {len(data) / raw_total:.1%})")
+
+def c_bytes(data, indent='    ', per_line=12):
+    """Bytes as lines of C hex literals."""
+    lines = []
+    for i in range(0, len(data), per_line):
+        lines.append(indent + ', '.join(f'0x{b:02X}' for b in data[i:i + per_line]) + ',')
+    return '\n'.join(lines)
+
+def write_atlas(assets, output_dir):
+    """Write sprite_atlas.h/.c: the frames of (name, id, width, height, frames)
+    tuples back to back in one const array, with a frame offset table and size
+    constants, for the assets asset_manager.c marks ASSET_STORAGE_EMBEDDED."""
+    if not assets:
+        raise ValueError("The atlas needs at least one asset")
+    ids = [asset[1] for asset in assets]
+    if len(set(ids)) != len(ids):
+        raise ValueError("Two inputs map to the same asset id")
+
+    offsets = []
+    data = b''
+    entries = []
+    for name, asset_id, width, height, frames in assets:
+        entries.append((name, asset_id, width, height, len(frames), len(frames[0]), len(offsets)))
+        for frame in frames:
+            offsets.append(len(data))
+            data += frame
+    if len(data) > 0xFFFF:
+        raise ValueError(f"{len(data)} bytes of frames do not fit the 16-bit atlas offsets")
+
+    header = [
+        "//*****************************************************************************",
+        "// Sprite Atlas",
+        "// Generated by Helper Programs/bitmap_converter.py --atlas, do not edit.",
+        "// Frames of the small sprites that are built into the application image,",
+        "// back to back in g_spriteAtlas. Frame n of an asset starts at",
+        "// g_spriteAtlasOffsets[firstFrame + n].",
+        "//*****************************************************************************",
+        "",
+        "#ifndef SPRITE_ATLAS_H_",
+        "#define SPRITE_ATLAS_H_",
+        "",
+        "#include <stdint.h>",
+        "",
+        f"#define SPRITE_ATLAS_BYTES              {len(data)}",
+        f"#define SPRITE_ATLAS_ASSET_COUNT        {len(entries)}",
+        f"#define SPRITE_ATLAS_FRAME_COUNT        {len(offsets)}",
+        "",
+    ]
+    for name, asset_id, width, height, count, size, first in entries:
+        macro = 'ATLAS_' + name.upper()
+        header += [
+            f"#define {macro + '_WIDTH':<40}{width}",
+            f"#define {macro + '_HEIGHT':<40}{height}",
+            f"#define {macro + '_FRAME_COUNT':<40}{count}",
+            f"#define {macro + '_FIRST_FRAME':<40}{first}",
+            "",
+        ]
+    header += [
+        "typedef struct {",
+        "    uint16_t assetId;               // AssetId in asset_manager.h",
+        "    uint16_t width;",
+        "    uint16_t height;",
+        "    uint16_t frameCount;",
+        "    uint16_t frameSize;             // bytes per frame",
+        "    uint16_t firstFrame;            // index into g_spriteAtlasOffsets",
+        "} SpriteAtlasAsset;",
+        "",
+        "extern const uint8_t g_spriteAtlas[SPRITE_ATLAS_BYTES];",
+        "extern const uint16_t g_spriteAtlasOffsets[SPRITE_ATLAS_FRAME_COUNT];",
+        "extern const SpriteAtlasAsset g_spriteAtlasAssets[SPRITE_ATLAS_ASSET_COUNT];",
+        "",
+        "#endif /* SPRITE_ATLAS_H_ */",
+    ]
+
+    source = [
+        "//*****************************************************************************",
+        "// Sprite Atlas",
+        "// Generated by Helper Programs/bitmap_converter.py --atlas, do not edit.",
+        "// See sprite_atlas.h.",
+        "//*****************************************************************************",
+        "",
+        "#include <stdint.h>",
+        "#include \"sprite_atlas.h\"",
+        "",
+        "const SpriteAtlasAsset g_spriteAtlasAssets[SPRITE_ATLAS_ASSET_COUNT] = {",
+    ]
+    for name, asset_id, width, height, count, size, first in entries:
+        source.append(f"    {{{asset_id:2}, {width:3}, {height:3}, {count:2}, {size:4}, {first:3}}},   // {name}")
+    source += [
+        "};",
+        "",
+        "const uint16_t g_spriteAtlasOffsets[SPRITE_ATLAS_FRAME_COUNT] = {",
+    ]
+    for name, asset_id, width, height, count, size, first in entries:
+        source.append(f"    {', '.join(str(o) for o in offsets[first:first + count])},   // {name}")
+    source += [
+        "};",
+        "",
+        "const uint8_t g_spriteAtlas[SPRITE_ATLAS_BYTES] = {",
+    ]
+    for name, asset_id, width, height, count, size, first in entries:
+        for n in range(count):
+            start = offsets[first + n]
+            source.append(f"    // {name} frame {n}")
+            source.append(c_bytes(data[start:start + size]))
+    source.append("};")
+
+    for file_name, lines in (('sprite_atlas.h', header), ('sprite_atlas.c', source)):
+        with open(os.path.join(output_dir, file_name), 'w', newline='\r\n') as f:
+            f.write('\n'.join(lines) + '\n')
+
+    for name, asset_id, width, height, count, size, first in entries:
+        print(f"  {name}: id {asset_id}, {width}x{height}, {count} frames, {count * size} bytes")
+    print(f"Saved sprite_atlas.c/.h to {output_dir} ({len(data)} bytes, {len(entries)} assets)")
+
+def parse_asset_option(text):
+    """NAME:ID:WxH from --asset."""
+    match = re.match(r'^(\w+):(\d+):(\d+)x(\d+)$', text)
+    if not match:
+        raise argparse.ArgumentTypeError(f"expected NAME:ID:WxH, got '{text}'")
+    name, asset_id, width, height = match.group(1), *map(int, match.groups()[1:])
+    if asset_id >= ARCHIVE_MAX_IDS:
+        raise argparse.ArgumentTypeError(f"asset ids must be below {ARCHIVE_MAX_IDS}")
+    return name, (asset_id, width, height)
+
 def main():
     parser = argparse.ArgumentParser(description='Convert bitmap arrays in C/C++ headers to binary files')
-    parser.add_argument('header_file', help='Path to header file containing bitmap arrays')
+    parser.add_argument('inputs', nargs='+', metavar='header_file',
+                        help='Header file containing bitmap arrays (with --archive or --atlas also *Frames_all.bin files)')
     parser.add_argument('--output', '-o', default='output', help='Output directory for binary files')
-    
+    parser.add_argument('--archive', '-a', metavar='FILE',
+                        help='Pack every input into one archive (upload it as /assets.bin)')
+    parser.add_argument('--asset', action='append', default=[], type=parse_asset_option, metavar='NAME:ID:WxH',
+                        help='Add or override an asset id and size for --archive and --atlas')
+    parser.add_argument('--compress', '-c', action='store_true',
+                        help='PackBits-code the assets in --archive that get smaller')
+    parser.add_argument('--atlas', metavar='DIR',
+                        help='Write every input into sprite_atlas.c/.h in DIR, built into the firmware')
+
     args = parser.parse_args()
-    
-    try:
-        array_name, frames = extract_arrays_from_header(args.header_file)
-        save_frames_to_binary(array_name, frames, args.output)
-        print("Conversion completed successfully!")
-        
-        # Print instructions for using with CC3200
-        basename = os.path.basename(args.header_file).replace('.h', '')
-        print("\nCC3200 Usage Instructions:")
-        print("1. Use Uniflash to upload the binary files to your CC3200")
-        print("2. Access the files in your code using:")
-        print(f"   char filename[32];")
-        print(f"   sprintf(filename, \"/{array_name}_%d.bin\", frame_index);")
-        print(f"   // Then open the file with sl_FsOpen() and read it")
-        
-    except Exception as e:
-        print(f"Error: {e}")
+
+    if args.atlas:
+        assets = dict(KNOWN_ASSETS)
+        assets.update(args.asset)
+        try:
+            write_atlas([load_asset(path, assets) for path in args.inputs], args.atlas)
+            print("\nCC3200 Usage Instructions:")
+            print("1. Mark these assets ASSET_STORAGE_EMBEDDED in g_assets (asset_manager.c) and rebuild")
+            print("2. Check the atlas size in the linker map with map_size_report.py")
+        except Exception as e:
+            print(f"Error: {e}")
+        return
+
+    if args.archive:
+        assets = dict(KNOWN_ASSETS)
+        assets.update(args.asset)
+        try:
+            write_archive([load_asset(path, assets) for path in args.inputs], args.archive, args.compress)
+            print("\nCC3200 Usage Instructions:")
+            print("1. Use Uniflash to upload the archive to your CC3200 as /assets.bin")
+            print("2. AssetManager_OpenArchive() picks it up at startup; the per-frame files are no longer needed")
+        except Exception as e:
+            print(f"Error: {e}")
+        return
+
+    for header_file in args.inputs:
+        try:
+            array_name, frames = extract_arrays_from_header(header_file)
+            save_frames_to_binary(array_name, frames, args.output)
+            print("Conversion completed successfully!")
+
+            # Print instructions for using with CC3200
+            basename = os.path.basename(header_file).replace('.h', '')
+            print("\nCC3200 Usage Instructions:")
+            print("1. Use Uniflash to upload the binary files to your CC3200")
+            print("2. Access the files in your code using:")
+            print(f"   char filename[32];")
+            print(f"   sprintf(filename, \"/{array_name}_%d.bin\", frame_index);")
+            print(f"   // Then open the file with sl_FsOpen() and read it")
+
+        except Exception as e:
+            print(f"Error: {e}")
 
 if __name__ == "__main__":
-    main()
\ No newline at end of file
+    main()
@@ -1,6 +1,13 @@
 from PIL import Image, ImageSequence
 import numpy as np
 import os
+import struct
+
+# Delta animation files, read by Program Code/animation_player.c
+ANIM_MAGIC = b'BMPA'
+ANIM_VERSION = 1
+ANIM_MAX_FRAMES = 64
+ANIM_TILE_ROWS = 8        # tiles are one byte (8 pixels) wide and this many rows high
 
 def gif_to_monochrome_bitmaps(gif_path, output_width=128, output_height=128, threshold=128, output_c_file="bitmap_animation.h"):
     """
@@ -183,6 +190,141 @@ def image_to_monochrome_bitmap(image_path, output_width=128, output_height=128,
         print(f"Error processing image: {e}")
         return None, None
 
+def changed_rects(prev, cur, bytes_per_row, height, tile_rows=ANIM_TILE_ROWS):
+    """
+    Find the rectangles of tiles that differ between two frames
+
+    Args:
+        prev: Bitmap data of the frame on screen
+        cur: Bitmap data of the next frame
+        bytes_per_row: Bytes in one bitmap row
+        height: Rows in a frame
+        tile_rows: Rows in one tile
+
+    Returns:
+        list: (x, y, w, h) rectangles, x and w in bytes, covering every changed byte
+    """
+    def row_changed(y, x0, x1):
+        start = y * bytes_per_row
+        return prev[start + x0:start + x1] != cur[start + x0:start + x1]
+
+    rects = []
+    open_spans = {}  # (x0, x1) -> [top, bottom] of a rectangle still growing down
+
+    for y0 in range(0, height, tile_rows):
+        y1 = min(height, y0 + tile_rows)
+
+        # Runs of changed tiles across this band of rows
+        changed = [any(prev[y * bytes_per_row + x] != cur[y * bytes_per_row + x]
+                       for y in range(y0, y1)) for x in range(bytes_per_row)]
+        spans = []
+        x = 0
+        while x < bytes_per_row:
+            if changed[x]:
+                start = x
+                while x < bytes_per_row and changed[x]:
+                    x += 1
+                spans.append((start, x))
+            else:
+                x += 1
+
+        # A run with the same columns as one in the band above extends it
+        next_spans = {}
+        for span in spans:
+            if span in open_spans:
+                next_spans[span] = open_spans.pop(span)
+                next_spans[span][1] = y1
+            else:
+                next_spans[span] = [y0, y1]
+        for (x0, x1), (top, bottom) in open_spans.items():
+            rects.append((x0, x1, top, bottom))
+        open_spans = next_spans
+
+    for (x0, x1), (top, bottom) in open_spans.items():
+        rects.append((x0, x1, top, bottom))
+
+    # Drop unchanged rows from the top and bottom of each rectangle
+    trimmed = []
+    for x0, x1, top, bottom in rects:
+        while not row_changed(top, x0, x1):
+            top += 1
+        while not row_changed(bottom - 1, x0, x1):
+            bottom -= 1
+        trimmed.append((x0, top, x1 - x0, bottom - top))
+
+    return sorted(trimmed, key=lambda r: (r[1], r[0]))
+
+def encode_animation_record(frame, rects, bytes_per_row):
+    """
+    Pack rectangles of a frame into one animation record
+    """
+    record = struct.pack('<H', len(rects))
+    for x, y, w, h in rects:
+        record += struct.pack('<BBBB', x, y, w, h)
+        for row in range(y, y + h):
+            start = row * bytes_per_row + x
+            record += frame[start:start + w]
+    return record
+
+def write_delta_animation(frames, width, height, fps, output_path):
+    """
+    Write frames as a keyframe plus per-frame deltas for animation_player.c
+
+    Record 0 draws the first frame in full, record n draws frame n over frame
+    n - 1 and the last record draws the first frame over the last one, so the
+    animation loops. A delta that would be larger than the whole frame is
+    stored as the whole frame.
+
+    Args:
+        frames: List of bitmap data, one per frame
+        width: Frame width in pixels
+        height: Frame height in pixels
+        fps: Playback rate in frames per second
+        output_path: Path of the .anim file to write
+
+    Returns:
+        dict: Sizes in bytes and the share of pixels redrawn per frame
+    """
+    if not frames or len(frames) > ANIM_MAX_FRAMES:
+        raise ValueError(f"Animations need 1 to {ANIM_MAX_FRAMES} frames, got {len(frames)}")
+
+    bytes_per_row = (width + 7) // 8
+    whole = [(0, 0, bytes_per_row, height)]
+
+    records = [encode_animation_record(frames[0], whole, bytes_per_row)]
+    redrawn = 0
+    for index in range(1, len(frames) + 1):
+        prev = frames[index - 1]
+        cur = frames[index % len(frames)]
+        rects = changed_rects(prev, cur, bytes_per_row, height)
+        record = encode_animation_record(cur, rects, bytes_per_row)
+        if len(record) > len(records[0]):
+            rects = whole
+            record = encode_animation_record(cur, whole, bytes_per_row)
+        redrawn += sum(w * h for _, _, w, h in rects)
+        records.append(record)
+
+    header = struct.pack('<4sHHHHHH', ANIM_MAGIC, ANIM_VERSION, len(frames),
+                         width, height, fps, 0)
+    offset = len(header) + 4 * (len(records) + 1)
+    table = b''
+    for record in records:
+        table += struct.pack('<I', offset)
+        offset += len(record)
+    table += struct.pack('<I', offset)
+
+    with open(output_path, 'wb') as f:
+        f.write(header + table + b''.join(records))
+
+    frame_size = bytes_per_row * height
+    return {
+        'file_bytes': offset,
+        'raw_bytes': frame_size * len(frames),
+        'keyframe_bytes': len(records[0]),
+        'delta_bytes': sum(len(r) for r in records[1:]) / len(frames),
+        'redrawn': redrawn / (frame_size * len(frames)),
+    }
+
 def preview_bitmap(bitmap_data, width, height):
     """
     Generate a simple ASCII preview of the bitmap
@@ -208,6 +350,8 @@ def convert_image():
     height = 128                 # Output height in pixels
     threshold = 100               # Threshold for black/white conversion (0-255)
     output_c_file = "C:/Users/lfiel/Desktop/Final_172_LAB/loading_screen_bitmap.h"    # Output C header file
+    output_anim_file = "C:/Users/lfiel/Desktop/Final_172_LAB/loading_screen.anim"    # Delta animation, upload as /loading_screen.anim
+    fps = 30                      # Animation playback rate
     
     result, c_array = image_to_monochrome_bitmap(image_path, width, height, threshold, output_c_file)
     
@@ -217,6 +361,11 @@ def convert_image():
             print(f"Successfully converted {image_path} to {len(result)} frames at {width}x{height} pixels")
             if output_c_file:
                 print(f"C array with {len(result)} frames written to {output_c_file}")
+            if output_anim_file:
+                stats = write_delta_animation(result, width, height, fps, output_anim_file)
+                print(f"Delta animation written to {output_anim_file}: {stats['file_bytes']} bytes "
+                      f"({100.0 * stats['file_bytes'] / stats['raw_bytes']:.1f}% of the raw frames), "
+                      f"{stats['delta_bytes']:.0f} bytes and {100.0 * stats['redrawn']:.1f}% of the screen per frame")
             
             # Preview the first frame
             print("\nPreview of first frame:")
@@ -0,0 +1,159 @@
+import re
+import sys
+import argparse
+
+# Reads the linker map CCS writes next to the .out file (Debug/<project>.map,
+# TI ARM linker format) and reports how much of the image a module takes,
+# by default the sprite atlas generated by bitmap_converter.py --atlas, and
+# how much of a memory region (SRAM_DATA unless told otherwise) is left.
+
+INPUT_SECTION = re.compile(r'^\s+([0-9a-f]{8})\s+([0-9a-f]{8})\s+(.*)$')
+OUTPUT_SECTION = re.compile(r'^(\.\S+|\S+)\s+\d+\s+([0-9a-f]{8})\s+([0-9a-f]{8})')
+MEMORY_REGION = re.compile(r'^\s+(\w+)\s+([0-9a-f]{8})\s+([0-9a-f]{8})\s+([0-9a-f]{8})\s+([0-9a-f]{8})')
+MODULE_ROW = re.compile(r'^\s+(\S+\.obj)\s+(\d+)\s+(\d+)\s+(\d+)\s*$')
+
+def parse_map(path):
+    """
+    Pull the memory regions, input sections and module summary out of a map
+
+    Returns:
+        dict: 'regions' [(name, length, used)], 'sections' [(output section,
+              module, input section, size)], 'modules' {module: (code, ro, rw)}
+    """
+    with open(path, 'r', errors='replace') as f:
+        lines = f.read().splitlines()
+
+    regions = []
+    sections = []
+    modules = {}
+    part = None
+    output_section = None
+    library = ''
+
+    for line in lines:
+        if line.startswith('MEMORY CONFIGURATION'):
+            part = 'memory'
+            continue
+        if line.startswith('SEGMENT ALLOCATION MAP'):
+            part = None
+            continue
+        if line.startswith('SECTION ALLOCATION MAP'):
+            part = 'sections'
+            continue
+        if line.startswith('MODULE SUMMARY'):
+            part = 'modules'
+            continue
+        if line.startswith('GLOBAL SYMBOLS') or line.startswith('LINKER GENERATED'):
+            part = None
+            continue
+
+        if part == 'memory':
+            match = MEMORY_REGION.match(line)
+            if match:
+                regions.append((match.group(1), int(match.group(3), 16), int(match.group(4), 16)))
+
+        elif part == 'sections':
+            match = OUTPUT_SECTION.match(line)
+            if match:
+                output_section = match.group(1)
+                continue
+            match = INPUT_SECTION.match(line)
+            if not match or '--HOLE--' in match.group(3):
+                continue
+            rest = match.group(3).strip()
+
+            # "lib.a : member.obj (.sect)", ": member.obj (.sect)" for the
+            # same library again, or "module.obj (.sect)"
+            if ':' in rest.split('(')[0]:
+                lib, rest = rest.split(':', 1)
+                if lib.strip():
+                    library = lib.strip()
+                module = library + ' : ' + rest.split('(')[0].strip()
+            else:
+                library = ''
+                module = rest.split('(')[0].strip()
+            input_section = rest[rest.find('(') + 1:rest.rfind(')')] if '(' in rest else ''
+            sections.append((output_section, module, input_section, int(match.group(2), 16)))
+
+        elif part == 'modules':
+            match = MODULE_ROW.match(line)
+            if match:
+                code, ro, rw = map(int, match.groups()[1:])
+                old = modules.get(match.group(1), (0, 0, 0))
+                modules[match.group(1)] = (old[0] + code, old[1] + ro, old[2] + rw)
+
+    return {'regions': regions, 'sections': sections, 'modules': modules}
+
+def module_matches(module, name):
+    """True for name itself or a library member of that name."""
+    return module == name or module.endswith(' : ' + name)
+
+def main():
+    parser = argparse.ArgumentParser(description='Report what a module takes in a TI linker map file')
+    parser.add_argument('map_file', help='Linker map, e.g. Debug/<project>.map')
+    parser.add_argument('--module', '-m', default='sprite_atlas.obj',
+                        help='Object file to report (default: sprite_atlas.obj)')
+    parser.add_argument('--top', '-t', type=int, default=10,
+                        help='Also list this many of the largest input sections (default: 10)')
+    parser.add_argument('--budget', '-b', type=int, metavar='BYTES',
+                        help='Exit with status 1 when the module is larger than this')
+    parser.add_argument('--region', '-r', default='SRAM_DATA',
+                        help='Memory region --headroom applies to (default: SRAM_DATA)')
+    parser.add_argument('--headroom', type=int, metavar='BYTES',
+                        help='Exit with status 1 when --region has less than this left unused')
+
+    args = parser.parse_args()
+
+    try:
+        info = parse_map(args.map_file)
+    except OSError as e:
+        print(f"Error: {e}")
+        sys.exit(2)
+
+    print("Memory regions:")
+    for name, length, used in info['regions']:
+        print(f"  {name:<16} {used:>7} of {length:>7} bytes used ({used / length:.1%})")
+
+    own = [s for s in info['sections'] if module_matches(s[1], args.module)]
+    total = sum(s[3] for s in own)
+    print(f"\n{args.module}:")
+    if not own:
+        print("  not in this map (is it part of the build?)")
+    for output_section, module, input_section, size in own:
+        print(f"  {input_section:<40} {size:>7} bytes in {output_section}")
+    summary = info['modules'].get(args.module)
+    if summary:
+        print(f"  module summary: code {summary[0]}, ro data {summary[1]}, rw data {summary[2]}")
+    print(f"  total {total} bytes")
+    for name, length, used in info['regions']:
+        if name == 'SRAM_CODE' and length:
+            print(f"  {total / length:.2%} of {name}")
+
+    if args.top > 0:
+        print(f"\nLargest {args.top} input sections:")
+        for output_section, module, input_section, size in sorted(info['sections'], key=lambda s: -s[3])[:args.top]:
+            print(f"  {size:>7}  {module} ({input_section})")
+
+    failed = False
+    if args.budget is not None and total > args.budget:
+        print(f"\n{args.module} is {total} bytes, over the {args.budget} byte budget")
+        failed = True
+
+    if args.headroom is not None:
+        region = [r for r in info['regions'] if r[0] == args.region]
+        if not region:
+            print(f"\nNo {args.region} region in this map")
+            failed = True
+        else:
+            name, length, used = region[0]
+            free = length - used
+            print(f"\n{name}: {free} bytes free, {args.headroom} required")
+            if free < args.headroom:
+                print(f"{name} is short of the required headroom by {args.headroom - free} bytes")
+                failed = True
+
+    if failed:
+        sys.exit(1)
+
+if __name__ == "__main__":
+    main()
@@ -38,6 +38,9 @@
 #include "question_display.h"
 #include "loading_screen_bitmap.h"
 #include "connected_bitmap.h"
+#include "display_dma.h"
+#include "game_loop.h"
+#include "animation_player.h"
 
 // custom text entry
 #include "text_entry.h"
@@ -85,6 +88,15 @@
 
 #define GET_REQUEST_DELAY 60000000
 
+// Same waits in GameLoop ticks, MAP_UtilsDelay() spins 3 cycles per count
+#define GET_REQUEST_TICKS   (GET_REQUEST_DELAY * 3UL)
+#define CONNECT_POLL_TICKS  (800000 * 3UL)
+
+// Delta animations written by image_bitmap_generator.py
+#define LOADING_ANIMATION_FILE      "/loading_screen.anim"
+#define WIFILOADING_ANIMATION_FILE  "/wifiloading.anim"
+#define LOADING_BAR_WIDTH           115
+
 
 // Question type enumeration
 typedef enum {
@@ -105,6 +117,8 @@ static char g_current_question[256] = "ft232h";
 static char g_current_answer[512] = "No answer yet...";
 static bool g_in_text_entry = false;
 static question_type_t g_current_question_type = QUESTION_TYPE_NONE;
+static AnimationPlayer g_loading_animation;
+static AnimationPlayer g_wifi_animation;
 
 // Function prototypes
 static void display_status(void);
@@ -202,14 +216,35 @@ static void display_aws_error_ui(void) {
 }
 
 static void display_loading_screen(void){
-    int totalFrames = 12;
-    int i=0;
-    for(i=0; i<= totalFrames; i++){
-        MAP_UtilsDelay(GET_REQUEST_DELAY/totalFrames);
-        const uint8_t* loading_frame_bitmap = get_loading_screen_frame(i%LOADING_SCREEN_FRAME_COUNT);
-        fastDrawBitmap(0, 0, loading_frame_bitmap, 128, 128, GREEN, BLACK, 1);
-        // Draw loading bar filled rectangle
-        fillRect(8, 69, (115/totalFrames)*(i), 6, BLUE);
+    uint32_t start;
+    uint32_t elapsed = 0;
+
+    // Play the animation at its own rate for as long as the request delay,
+    // redrawing only the tiles that change between frames
+    AnimationPlayer_Open(&g_loading_animation, LOADING_ANIMATION_FILE, ASSET_LOADING_SCREEN);
+    AnimationPlayer_Start(&g_loading_animation, 0, 0, GREEN, BLACK);
+    start = GameLoop_Ticks();
+    while(elapsed < GET_REQUEST_TICKS){
+        if(AnimationPlayer_Update(&g_loading_animation)){
+            // Draw loading bar filled rectangle over the new frame
+            fillRect(8, 69, (int)(((uint64_t)LOADING_BAR_WIDTH * elapsed) / GET_REQUEST_TICKS), 6, BLUE);
+        }
+        elapsed = GameLoop_Ticks() - start;
+    }
+    AnimationPlayer_Close(&g_loading_animation);
+}
+
+//*****************************************************************************
+// Wait while the wifi loading animation keeps playing
+//*****************************************************************************
+static void wait_wifi_animation(uint32_t ticks) {
+    uint32_t start;
+
+    GameLoop_InitClock();
+    start = GameLoop_Ticks();
+
+    while(GameLoop_Ticks() - start < ticks){
+        AnimationPlayer_Update(&g_wifi_animation);
     }
 }
 
@@ -225,8 +260,7 @@ static void on_enter_pressed(const char* question) {
 
     // display first frame of loading bitmap before anything is done so it feels responsive
     // this is a very hacky way to do this, :(
-    const uint8_t* loading_frame_bitmap = get_loading_screen_frame(0);
-    fastDrawBitmap(0, 0, loading_frame_bitmap, 128, 128, GREEN, BLACK, 1);
+    AssetManager_DrawFrame(ASSET_LOADING_SCREEN, 0, 0, 0, GREEN, BLACK);
 
     // Update our current question
     strncpy(g_current_question, question, sizeof(g_current_question) - 1);
@@ -641,8 +675,8 @@ static int SimplifiedWiFiConnect(void) {
         // Process SimpleLink events
         _SlNonOsMainLoopTask();
 
-        // Small delay
-        MAP_UtilsDelay(800000);
+        // Small delay, the wifi animation keeps running through it
+        wait_wifi_animation(CONNECT_POLL_TICKS);
 
         // Print status periodically
         if (timeout_count % 10 == 0) {
@@ -732,20 +766,22 @@ void AWSIoT_Initialize(void) {
     UART_PRINT("g_app_config initialized\n\r");
 
     // Connect to WiFi
-    int wifiFrame = 0;
     lRetVal = -1;
 
-    // While trying to connect display wifi loading bitmap
+    // While trying to connect play the wifi loading animation, it keeps
+    // its frame rate through the waits inside SimplifiedWiFiConnect()
+    AnimationPlayer_Open(&g_wifi_animation, WIFILOADING_ANIMATION_FILE, ASSET_WIFILOADING);
+    AnimationPlayer_Start(&g_wifi_animation, 0, 0, GREEN, BLACK);
     while(lRetVal < 0){
-        const uint8_t* wifiloading_frame_bitmap = get_wifiloading_frame(wifiFrame%WIFILOADING_FRAME_COUNT);
-        fastDrawBitmap(0, 0, wifiloading_frame_bitmap, 128, 128, GREEN, BLACK, 1);
-        wifiFrame++;
         lRetVal = SimplifiedWiFiConnect();
+        AnimationPlayer_Update(&g_wifi_animation);
         //force exit if button 2 is pressed
         if(!(GPIOPinRead(BUTTON2_PORT, BUTTON2_PIN) == 0)){
+            AnimationPlayer_Close(&g_wifi_animation);
             return;
         }
     }
+    AnimationPlayer_Close(&g_wifi_animation);
 
     // Successfully connected to WiFi
     g_wifi_connected = true;
@@ -753,8 +789,7 @@ void AWSIoT_Initialize(void) {
 
     UART_PRINT("Connected to Wi-Fi!\n\r");
 
-    const uint8_t* connected_bitmap = get_connected_frame(0);
-    fastDrawBitmap(0, 0, connected_bitmap, 128, 128, GREEN, BLACK, 1);
+    AssetManager_DrawFrame(ASSET_CONNECTED, 0, 0, 0, GREEN, BLACK);
 
     // Set time for TLS
     lRetVal = set_time();
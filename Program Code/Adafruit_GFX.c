@@ -34,6 +34,8 @@ POSSIBILITY OF SUCH DAMAGE.
 #include "Adafruit_GFX.h"
 #include "Adafruit_SSD1351.h"
 #include "glcdfont.h"
+#include "framebuffer.h"
+#include "pixel_batch.h"
 #include <stdint.h>
 #include <stdbool.h>
 //#define pgm_read_byte(addr) (*(const unsigned char *)(addr))
@@ -47,6 +49,12 @@ unsigned int WHITE = 0xFFFF;
 unsigned int BLACK = 0x0000;
 char wrap = 1;
 
+// Clip rectangle for drawSprite(), inclusive-exclusive, whole screen by default
+static int clip_x0 = 0;
+static int clip_y0 = 0;
+static int clip_x1 = WIDTH;
+static int clip_y1 = HEIGHT;
+
 
 /*
 Adafruit_GFX(int w, int h):
@@ -175,6 +183,19 @@ void drawLine(int x0, int y0, int x1, int y1, unsigned int color) {
   int dx, dy;
     int err;
     int ystep;
+    int runStart;
+
+  // Axis-aligned lines are a single window
+  if (y0 == y1) {
+    if (x0 > x1) swap(x0, x1);
+    drawFastHLine(x0, y0, x1 - x0 + 1, color);
+    return;
+  }
+  if (x0 == x1) {
+    if (y0 > y1) swap(y0, y1);
+    drawFastVLine(x0, y0, y1 - y0 + 1, color);
+    return;
+  }
 
     steep = abs(y1 - y0) > abs(x1 - x0);
   if (steep) {
@@ -198,16 +219,40 @@ void drawLine(int x0, int y0, int x1, int y1, unsigned int color) {
     ystep = -1;
   }
 
-  for (; x0<=x1; x0++) {
-    if (steep) {
-      drawPixel(y0, x0, color);
-    } else {
-      drawPixel(x0, y0, color);
+  // Pixels queued in a batch are coalesced (and de-duplicated) there
+  if (PixelBatch_IsActive()) {
+    for (; x0<=x1; x0++) {
+      if (steep) {
+        drawPixel(y0, x0, color);
+      } else {
+        drawPixel(x0, y0, color);
+      }
+      err -= dy;
+      if (err < 0) {
+        y0 += ystep;
+        err += dx;
+      }
     }
+    return;
+  }
+
+  // Walk the major axis and emit each maximal run of pixels that share a
+  // minor coordinate as one fast line: horizontal runs for shallow lines,
+  // vertical runs for steep ones
+  runStart = x0;
+  for (; x0<=x1; x0++) {
     err -= dy;
-    if (err < 0) {
-      y0 += ystep;
-      err += dx;
+    if (err < 0 || x0 == x1) {
+      if (steep) {
+        drawFastVLine(y0, runStart, x0 - runStart + 1, color);
+      } else {
+        drawFastHLine(runStart, y0, x0 - runStart + 1, color);
+      }
+      runStart = x0 + 1;
+      if (err < 0) {
+        y0 += ystep;
+        err += dx;
+      }
     }
   }
 }
@@ -377,11 +422,116 @@ uint16_t getByte(const uint16_t *bitmap, uint16_t byteIndex) {
     }
 }
 
+// Set the rectangle drawSprite() clips against
+void setClipRect(int x, int y, int w, int h) {
+    clip_x0 = (x < 0) ? 0 : x;
+    clip_y0 = (y < 0) ? 0 : y;
+    clip_x1 = (x + w > WIDTH) ? WIDTH : x + w;
+    clip_y1 = (y + h > HEIGHT) ? HEIGHT : y + h;
+}
+
+void resetClipRect(void) {
+    setClipRect(0, 0, WIDTH, HEIGHT);
+}
+
+// Send one horizontal run of set pixels (source columns start..end-1 of a
+// row already mapped to screen row sy) as a single clipped fill
+static void drawSpriteRun(int x, int sy, int width, int start, int end,
+                          uint16_t color, int pixelSize, uint8_t flags) {
+    int sx0, sx1;
+    int ry0 = sy, ry1 = sy + pixelSize;
+
+    if (flags & SPRITE_FLIP_H) {
+        sx0 = x + (width - end) * pixelSize;
+        sx1 = x + (width - start) * pixelSize;
+    } else {
+        sx0 = x + start * pixelSize;
+        sx1 = x + end * pixelSize;
+    }
+
+    if (sx0 < clip_x0) sx0 = clip_x0;
+    if (sx1 > clip_x1) sx1 = clip_x1;
+    if (ry0 < clip_y0) ry0 = clip_y0;
+    if (ry1 > clip_y1) ry1 = clip_y1;
+
+    if (sx0 < sx1 && ry0 < ry1) {
+        fillRect(sx0, ry0, sx1 - sx0, ry1 - ry0, color);
+    }
+}
+
+// Transparent 1bpp blit. Each source row is decoded into runs of set bits
+// and each run goes out as one window (pixelSize rows tall), so the cost
+// follows the number of opaque runs rather than opaque pixels. Background
+// bits are left untouched. flags takes SPRITE_FLIP_H / SPRITE_FLIP_V.
+void drawSprite(int x, int y, const uint8_t *bitmap, int width, int height,
+                uint16_t color, int pixelSize, uint8_t flags) {
+    int byteWidth = (width + 7) / 8;
+    int j, i, start, sy;
+
+    if (pixelSize < 1) return;
+
+    // Whole sprite outside the clip rectangle
+    if (x >= clip_x1 || y >= clip_y1 ||
+        x + width * pixelSize <= clip_x0 || y + height * pixelSize <= clip_y0) {
+        return;
+    }
+
+    for (j = 0; j < height; j++) {
+        const uint8_t *row = &bitmap[j * byteWidth];
+
+        if (flags & SPRITE_FLIP_V) {
+            sy = y + (height - 1 - j) * pixelSize;
+        } else {
+            sy = y + j * pixelSize;
+        }
+        if (sy >= clip_y1 || sy + pixelSize <= clip_y0) continue;
+
+        i = 0;
+        while (i < width) {
+            // Skip clear pixels, a whole byte at a time where possible
+            if ((i & 7) == 0 && row[i >> 3] == 0) {
+                i += 8;
+                continue;
+            }
+            if (!(row[i >> 3] & (0x80 >> (i & 7)))) {
+                i++;
+                continue;
+            }
+
+            // Extend the run over set pixels, a whole byte at a time where possible
+            start = i;
+            while (i < width) {
+                if ((i & 7) == 0 && row[i >> 3] == 0xFF && i + 8 <= width) {
+                    i += 8;
+                } else if (row[i >> 3] & (0x80 >> (i & 7))) {
+                    i++;
+                } else {
+                    break;
+                }
+            }
+
+            drawSpriteRun(x, sy, width, start, i, color, pixelSize, flags);
+        }
+    }
+}
+
 // Updated drawBitmap function
 void drawBitmap(int x, int y, const uint8_t *bitmap, int width, int height, uint16_t color,
                 int pixelSize, bool drawBackground, uint16_t backgroundColor) {
     int byteWidth = (width + 7) / 8; // Bytes per row
 
+    // Transparent bitmaps go out as runs
+    if (!drawBackground) {
+        drawSprite(x, y, bitmap, width, height, color, pixelSize, 0);
+        return;
+    }
+
+    // Opaque bitmaps that fit on screen stream as one window
+    if (x >= 0 && y >= 0 && x + width * pixelSize <= WIDTH && y + height * pixelSize <= HEIGHT) {
+        fastDrawBitmap(x, y, bitmap, width, height, color, backgroundColor, pixelSize);
+        return;
+    }
+
     int j = 0;
     int i = 0;
     int py = 0;
@@ -480,6 +630,118 @@ void write(unsigned char c) {
 }
 */
 // Draw a character
+/*
+   Glyph cache
+
+   Recently drawn glyphs are kept as expanded 6x8 RGB565 cells (row-major,
+   including the blank sixth column) keyed by character and color pair, so
+   redrawing a label costs table lookups instead of bit tests. The least
+   recently used cell is replaced on a miss.
+*/
+#define GLYPH_CACHE_SIZE    32
+#define GLYPH_MAX_LINE      (WIDTH / 6)
+
+typedef struct {
+  bool valid;
+  unsigned char c;
+  uint16_t fg;
+  uint16_t bg;
+  unsigned long lastUse;
+  uint16_t cell[6 * 8];
+} GlyphCacheEntry;
+
+static GlyphCacheEntry glyph_cache[GLYPH_CACHE_SIZE];
+static unsigned long glyph_clock = 0;
+
+static const uint16_t* getGlyphCell(unsigned char c, uint16_t fg, uint16_t bg) {
+  GlyphCacheEntry *entry;
+  unsigned char line;
+  int k, i, j;
+  int victim = 0;
+
+  glyph_clock++;
+
+  for (k = 0; k < GLYPH_CACHE_SIZE; k++) {
+    entry = &glyph_cache[k];
+    if (entry->valid && entry->c == c && entry->fg == fg && entry->bg == bg) {
+      entry->lastUse = glyph_clock;
+      return entry->cell;
+    }
+    if (!entry->valid) {
+      victim = k;
+    } else if (glyph_cache[victim].valid && entry->lastUse < glyph_cache[victim].lastUse) {
+      victim = k;
+    }
+  }
+
+  entry = &glyph_cache[victim];
+  for (i = 0; i < 6; i++) {
+    line = (i == 5) ? 0x0 : font[(c*5)+i];
+    for (j = 0; j < 8; j++) {
+      entry->cell[j*6 + i] = (line & 0x1) ? fg : bg;
+      line >>= 1;
+    }
+  }
+  entry->c = c;
+  entry->fg = fg;
+  entry->bg = bg;
+  entry->lastUse = glyph_clock;
+  entry->valid = true;
+
+  return entry->cell;
+}
+
+// A run of n opaque glyphs can go out as one window when it is entirely on
+// screen and the shadow framebuffer is not capturing drawing
+static bool glyphWindowOk(int x, int y, int n, unsigned int color, unsigned int bg,
+                          unsigned char size) {
+  return (bg != color) && !Framebuffer_IsEnabled() && (n > 0) && (n <= GLYPH_MAX_LINE) &&
+         (x >= 0) && (y >= 0) && (x + 6 * size * n <= WIDTH) && (y + 8 * size <= HEIGHT);
+}
+
+// Stream n glyphs side by side through one display window, row by row
+static void drawGlyphLine(int x, int y, const char *str, int n,
+                          unsigned int color, unsigned int bg, unsigned char size) {
+  const uint16_t *cells[GLYPH_MAX_LINE];
+  int k, i, j, py;
+
+  for (k = 0; k < n; k++) {
+    cells[k] = getGlyphCell(str[k], color, bg);
+  }
+
+  beginWindow(x, y, 6 * size * n, 8 * size);
+  for (j = 0; j < 8; j++) {
+    for (py = 0; py < size; py++) {
+      for (k = 0; k < n; k++) {
+        const uint16_t *row = &cells[k][j * 6];
+        if (size == 1) {
+          pushPixels(row, 6);
+        } else {
+          for (i = 0; i < 6; i++) {
+            pushColor(row[i], size);
+          }
+        }
+      }
+    }
+  }
+  endWindow();
+}
+
+// Draw n characters of str in one window where possible
+void drawTextLine(int x, int y, const char *str, int n,
+                  unsigned int color, unsigned int bg, unsigned char size) {
+  int k;
+
+  if (glyphWindowOk(x, y, n, color, bg, size)) {
+    drawGlyphLine(x, y, str, n, color, bg, size);
+    return;
+  }
+
+  for (k = 0; k < n; k++) {
+    drawChar(x + k * 6 * size, y, str[k], color, bg, size);
+  }
+}
+
 void drawChar(int x, int y, unsigned char c,
                 unsigned int color, unsigned int bg, unsigned char size) {
 
@@ -487,6 +749,11 @@ void drawChar(int x, int y, unsigned char c,
   char i;
   char j;
 
+  if (glyphWindowOk(x, y, 1, color, bg, size)) {
+    drawGlyphLine(x, y, (const char *)&c, 1, color, bg, size);
+    return;
+  }
+
   if((x >= WIDTH)            || // Clip right
      (y >= HEIGHT)           || // Clip bottom
      ((x + 6 * size - 1) < 0) || // Clip left
@@ -530,17 +797,34 @@ void OutstrBlack (char * str) {
 
 void Outstr (char * str, int COLOR, int BACKGROUND_COLOR, int x1, int y1, int x2, int y2) {
     char * ptr;
+    int n;
+    int line_x;
+    bool wrapped;
+
     cursor_x = x1;
     cursor_y = y1;
     ptr = str;
     while (*ptr) {
-        drawChar(cursor_x, cursor_y, *ptr++, COLOR, BACKGROUND_COLOR, textsize);
-        cursor_x += 6*textsize;
-        if((cursor_x + 6*textsize)>= x2){
+        /* Count the characters that share this line, then draw them together */
+        n = 0;
+        line_x = cursor_x;
+        wrapped = false;
+        while (ptr[n]) {
+            n++;
+            cursor_x += 6*textsize;
+            if((cursor_x + 6*textsize)>= x2){
+                wrapped = true;
+                break;
+            }
+        }
+
+        drawTextLine(line_x, cursor_y, ptr, n, COLOR, BACKGROUND_COLOR, textsize);
+        ptr += n;
+
+        if (wrapped) {
             cursor_y += 10*textsize;
             cursor_x = x1;
         }
-
     }
 
 }
@@ -16,6 +16,10 @@
 
 #define swap(a, b) {int t = a; a = b; b = t; }
 
+// drawSprite() flip flags
+#define SPRITE_FLIP_H   0x01
+#define SPRITE_FLIP_V   0x02
+
 // class Adafruit_GFX : public Print {
 
 // public:
@@ -47,10 +51,14 @@
     void drawRoundRect(int x0, int y0, int w, int h, int radius, unsigned int color);
     void fillRoundRect(int x0, int y0, int w, int h, int radius, unsigned int color);
     void drawBitmap(int x, int y, const uint8_t *bitmap, int width, int height, uint16_t color, int pixelSize, bool drawBackground, uint16_t backgroundColor);
+    void drawSprite(int x, int y, const uint8_t *bitmap, int width, int height, uint16_t color, int pixelSize, uint8_t flags);
+    void setClipRect(int x, int y, int w, int h);
+    void resetClipRect(void);
     uint16_t getByte(const uint16_t *array, uint16_t byteIndex);
 //    void drawBitmap(int x, int y, const unsigned char *bitmap, int w, int h, unsigned int color, unsigned int bg);
     void drawXBitmap(int x, int y, const unsigned char *bitmap, int w, int h, unsigned int color);
     void drawChar(int x, int y, unsigned char c, unsigned int color, unsigned int bg, unsigned char size);
+    void drawTextLine(int x, int y, const char *str, int n, unsigned int color, unsigned int bg, unsigned char size);
     void setCursor(int x, int y);
 //    void setTextColor(unsigned int c);
     void setTextColor(unsigned int c, unsigned int bg);
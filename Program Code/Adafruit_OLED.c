@@ -9,6 +9,7 @@
 #include "hw_memmap.h"
 #include "hw_common_reg.h"
 #include "hw_ints.h"
+#include "hw_mcspi.h"
 #include "gpio.h"
 #include "spi.h"
 #include "rom.h"
@@ -23,13 +24,42 @@
 #include "pinmux.h"
 
 #include "Adafruit_SSD1351.h"
+#include "Adafruit_GFX.h"
+#include "framebuffer.h"
+#include "display_dma.h"
+#include "pixel_batch.h"
 
 // flush buffer variable
 static unsigned long flush;
 
+// Vertical scroll state (display start line)
+static int g_scrollOffset = 0;
+
+// Pixels left before an open window wraps past the last RAM row, 0 if none
+static unsigned long g_wrapCountdown = 0;
+static int g_wrapRows = 0;
+
+#if SSD1351_STATS
+static DisplayStats g_displayStats[OLED_PRIM_COUNT];
+static int g_statsPrim = OLED_PRIM_OTHER;
+
+#define STATS_BEGIN(prim)   { g_statsPrim = (prim); g_displayStats[prim].calls++; }
+#define STATS_END()         { g_statsPrim = OLED_PRIM_OTHER; }
+#define STATS_BYTES(n)      { g_displayStats[g_statsPrim].bytes += (n); }
+#define STATS_TRANSACTION() { g_displayStats[g_statsPrim].transactions++; }
+#else
+#define STATS_BEGIN(prim)
+#define STATS_END()
+#define STATS_BYTES(n)
+#define STATS_TRANSACTION()
+#endif
+
 
 
 void writeCommand(unsigned char c) {
+    PixelBatch_Flush(); // queued pixels go out before any new command
+    Display_WaitIdle(); // never interleave with a background transfer
+
     GPIOPinWrite(GPIOA3_BASE, 0x10, 0x00); //Set DC pin low to indicate incoming command
 
     MAP_SPICSEnable(GSPI_BASE); // Enables CS line for peripheral to select OLED
@@ -40,6 +70,9 @@ void writeCommand(unsigned char c) {
 
     MAP_SPIDataGet(GSPI_BASE, &flush); //Reads back a dummy byte to complete transmission (I used claude to figure out this was needed)
 
+    STATS_TRANSACTION();
+    STATS_BYTES(1);
+
     GPIOPinWrite(GPIOA1_BASE, 0x80, 0xff); // Sets OLEDCS high, deselect OLED
 
     MAP_SPICSDisable(GSPI_BASE); //Disables CS line for unselecting OLED
@@ -47,6 +80,8 @@ void writeCommand(unsigned char c) {
 }
 
 void writeData(unsigned char c) {
+    Display_WaitIdle(); // never interleave with a background transfer
+
     GPIOPinWrite(GPIOA3_BASE, 0x10, 0xff); //Set DC pin high to indicate incoming data (I used claude to figure out this was needed)
 
     MAP_SPICSEnable(GSPI_BASE); // Enables CS line for peripheral to select OLED
@@ -57,6 +92,9 @@ void writeData(unsigned char c) {
 
     MAP_SPIDataGet(GSPI_BASE, &flush); //Reads back a dummy byte to complete transmission (I used claude to figure out this was needed)
 
+    STATS_TRANSACTION();
+    STATS_BYTES(1);
+
     GPIOPinWrite(GPIOA1_BASE, 0x80, 0xff); // Sets OLEDCS high, deselect OLED
 
     MAP_SPICSDisable(GSPI_BASE); //Disables CS line for unselecting OLED
@@ -148,6 +186,360 @@ void Adafruit_Init(void) {
   writeCommand(SSD1351_CMD_DISPLAYON);      //--turn on oled panel
 }
 
+/***********************************/
+/*
+   Streaming pixel window
+
+   beginWindow() selects the OLED once, sends the column/row window and
+   WRITERAM with DC toggled between command and argument bytes, then leaves
+   CS asserted with DC high. pushColor()/pushPixels() stream RGB565 pixels
+   into the window and endWindow() releases CS. The window must already be
+   clipped to the screen by the caller.
+*/
+/***********************************/
+
+static void spiSelect(void) {
+  MAP_SPICSEnable(GSPI_BASE);            // Enable CS
+  GPIOPinWrite(GPIOA1_BASE, 0x80, 0x00); // OLEDCS low
+  STATS_TRANSACTION();
+}
+
+static void spiDeselect(void) {
+  GPIOPinWrite(GPIOA1_BASE, 0x80, 0xff); // OLEDCS high
+  MAP_SPICSDisable(GSPI_BASE);           // Disable CS
+}
+
+static void spiWrite(unsigned char c) {
+  MAP_SPIDataPut(GSPI_BASE, c);
+  MAP_SPIDataGet(GSPI_BASE, &flush);
+  STATS_BYTES(1);
+}
+
+// Send a command byte followed by its argument bytes while CS is held
+static void spiCommand(unsigned char cmd, int argc, unsigned char a0, unsigned char a1) {
+  GPIOPinWrite(GPIOA3_BASE, 0x10, 0x00); // DC low for command
+  spiWrite(cmd);
+  GPIOPinWrite(GPIOA3_BASE, 0x10, 0xff); // DC high for data
+  if (argc > 0) spiWrite(a0);
+  if (argc > 1) spiWrite(a1);
+}
+
+void beginWindow(int x, int y, int w, int h) {
+  int row;
+  int rowsToEnd;
+
+  PixelBatch_Flush();
+  Display_WaitIdle();
+  spiSelect();
+
+  // Logical rows sit g_scrollOffset rows further down in display RAM. A
+  // window that runs past the last RAM row continues at row 0, which the
+  // push functions handle by reissuing the row range part way through.
+  row = (y + g_scrollOffset) % SSD1351HEIGHT;
+  rowsToEnd = SSD1351HEIGHT - row;
+  if (h > rowsToEnd) {
+    g_wrapRows = h - rowsToEnd;
+    g_wrapCountdown = (unsigned long)w * rowsToEnd;
+    h = rowsToEnd;
+  } else {
+    g_wrapCountdown = 0;
+  }
+
+  spiCommand(SSD1351_CMD_SETCOLUMN, 2, x, x + w - 1);
+  spiCommand(SSD1351_CMD_SETROW, 2, row, row + h - 1);
+  spiCommand(SSD1351_CMD_WRITERAM, 0, 0, 0); // pixel data follows
+}
+
+#if SSD1351_SPI_WORD_BITS == 8
+
+static void pushColorRun(unsigned int color, unsigned long n) {
+  unsigned char colorHigh = color >> 8;
+  unsigned char colorLow = color & 0xFF;
+
+  while (n--) {
+    spiWrite(colorHigh);
+    spiWrite(colorLow);
+  }
+}
+
+static void pushPixelRun(const uint16_t *buf, unsigned long n) {
+  while (n--) {
+    spiWrite(*buf >> 8);
+    spiWrite(*buf & 0xFF);
+    buf++;
+  }
+}
+
+static void endPixelPhase(void) {
+}
+
+#else
+/***********************************/
+/*
+   Packed pixel mode
+
+   The first push into a window reconfigures the channel for
+   SSD1351_SPI_WORD_BITS words, transmit-only, with the TX FIFO enabled.
+   Words are written with no read-back. endWindow() waits for the FIFO to
+   drain, restores 8-bit transmit/receive for the next command, drains
+   anything left in RX and releases CS. The panel sees the same MSB-first
+   byte stream either way, so a 32-bit word carries two pixels.
+*/
+/***********************************/
+
+#if SSD1351_SPI_WORD_BITS == 32
+#define PIXEL_WORD_LENGTH   SPI_WL_32
+#else
+#define PIXEL_WORD_LENGTH   SPI_WL_16
+#endif
+
+#define TRM_TX_ONLY         (2 << MCSPI_CH0CONF_TRM_S)
+
+static bool g_pixelMode = false;
+#if SSD1351_SPI_WORD_BITS == 32
+static bool g_halfWordPending = false;  // one pixel waiting for its partner
+static unsigned long g_halfWord;
+#endif
+
+// Channel configuration may only change while the channel is disabled
+static void setChannelMode(unsigned long wordLength, unsigned long trm) {
+  unsigned long conf;
+
+  MAP_SPIDisable(GSPI_BASE);
+  conf = HWREG(GSPI_BASE + MCSPI_O_CH0CONF);
+  conf &= ~(MCSPI_CH0CONF_WL_M | MCSPI_CH0CONF_TRM_M);
+  HWREG(GSPI_BASE + MCSPI_O_CH0CONF) = conf | wordLength | trm;
+  MAP_SPIEnable(GSPI_BASE);
+}
+
+static void enterPixelMode(void) {
+  MAP_SPIFIFOLevelSet(GSPI_BASE, 1, 1);
+  MAP_SPIFIFOEnable(GSPI_BASE, SPI_TX_FIFO);
+  setChannelMode(PIXEL_WORD_LENGTH, TRM_TX_ONLY);
+  g_pixelMode = true;
+}
+
+static void waitTxDone(void) {
+  while (!(HWREG(GSPI_BASE + MCSPI_O_CH0STAT) & MCSPI_CH0STAT_EOT)) {
+  }
+}
+
+static void leavePixelMode(void) {
+#if SSD1351_SPI_WORD_BITS == 32
+  // An odd pixel count leaves half a word, send it as a 16-bit word
+  if (g_halfWordPending) {
+    waitTxDone();
+    setChannelMode(SPI_WL_16, TRM_TX_ONLY);
+    MAP_SPIDataPut(GSPI_BASE, g_halfWord >> 16);
+    STATS_BYTES(2);
+    g_halfWordPending = false;
+  }
+#endif
+
+  waitTxDone();
+  MAP_SPIFIFODisable(GSPI_BASE, SPI_TX_FIFO);
+  setChannelMode(SPI_WL_8, 0);
+
+  // Drain anything that was clocked in while transmitting
+  while (HWREG(GSPI_BASE + MCSPI_O_CH0STAT) & MCSPI_CH0STAT_RXS) {
+    flush = HWREG(GSPI_BASE + MCSPI_O_RX0);
+  }
+
+  g_pixelMode = false;
+}
+
+#if SSD1351_SPI_WORD_BITS == 32
+
+static void pushColorRun(unsigned int color, unsigned long n) {
+  unsigned long word;
+
+  if (n == 0) return;
+  if (!g_pixelMode) enterPixelMode();
+
+  color &= 0xFFFF;
+  if (g_halfWordPending) {
+    MAP_SPIDataPut(GSPI_BASE, g_halfWord | color);
+    STATS_BYTES(4);
+    g_halfWordPending = false;
+    n--;
+  }
+
+  word = ((unsigned long)color << 16) | color;
+  for (; n >= 2; n -= 2) {
+    MAP_SPIDataPut(GSPI_BASE, word);
+    STATS_BYTES(4);
+  }
+
+  if (n) {
+    g_halfWord = (unsigned long)color << 16;
+    g_halfWordPending = true;
+  }
+}
+
+static void pushPixelRun(const uint16_t *buf, unsigned long n) {
+  if (n == 0) return;
+  if (!g_pixelMode) enterPixelMode();
+
+  if (g_halfWordPending) {
+    MAP_SPIDataPut(GSPI_BASE, g_halfWord | *buf++);
+    STATS_BYTES(4);
+    g_halfWordPending = false;
+    n--;
+  }
+
+  for (; n >= 2; n -= 2) {
+    MAP_SPIDataPut(GSPI_BASE, ((unsigned long)buf[0] << 16) | buf[1]);
+    STATS_BYTES(4);
+    buf += 2;
+  }
+
+  if (n) {
+    g_halfWord = (unsigned long)*buf << 16;
+    g_halfWordPending = true;
+  }
+}
+
+#else
+
+static void pushColorRun(unsigned int color, unsigned long n) {
+  if (n == 0) return;
+  if (!g_pixelMode) enterPixelMode();
+
+  color &= 0xFFFF;
+  while (n--) {
+    MAP_SPIDataPut(GSPI_BASE, color);
+    STATS_BYTES(2);
+  }
+}
+
+static void pushPixelRun(const uint16_t *buf, unsigned long n) {
+  if (n == 0) return;
+  if (!g_pixelMode) enterPixelMode();
+
+  while (n--) {
+    MAP_SPIDataPut(GSPI_BASE, *buf++);
+    STATS_BYTES(2);
+  }
+}
+
+#endif // SSD1351_SPI_WORD_BITS == 32
+
+static void endPixelPhase(void) {
+  if (g_pixelMode) {
+    leavePixelMode();
+  }
+}
+
+#endif // SSD1351_SPI_WORD_BITS == 8
+
+// Continue a window that ran off the bottom of display RAM at row 0
+static void wrapWindow(void) {
+  endPixelPhase();
+  spiCommand(SSD1351_CMD_SETROW, 2, 0, g_wrapRows - 1);
+  spiCommand(SSD1351_CMD_WRITERAM, 0, 0, 0);
+  g_wrapCountdown = 0;
+}
+
+void pushColor(unsigned int color, unsigned long n) {
+  if (g_wrapCountdown && n >= g_wrapCountdown) {
+    pushColorRun(color, g_wrapCountdown);
+    n -= g_wrapCountdown;
+    wrapWindow();
+  } else if (g_wrapCountdown) {
+    g_wrapCountdown -= n;
+  }
+  pushColorRun(color, n);
+}
+
+void pushPixels(const uint16_t *buf, unsigned long n) {
+  if (g_wrapCountdown && n >= g_wrapCountdown) {
+    unsigned long first = g_wrapCountdown;
+    pushPixelRun(buf, first);
+    buf += first;
+    n -= first;
+    wrapWindow();
+  } else if (g_wrapCountdown) {
+    g_wrapCountdown -= n;
+  }
+  pushPixelRun(buf, n);
+}
+
+void endWindow(void) {
+  endPixelPhase();
+  spiDeselect();
+  g_wrapCountdown = 0;
+}
+
+/***********************************/
+/*
+   Hardware scrolling
+
+   Vertical scrolling moves the display start line (STARTLINE), which
+   rotates the whole 128-row panel; the controller has no partial vertical
+   scroll area. Drawing coordinates are remapped in beginWindow() and goTo()
+   so callers keep drawing in screen coordinates: after scrollLines(1) the
+   old row 1 is shown at y = 0 and the row that wrapped around is at the
+   bottom, ready to be redrawn.
+
+   Horizontal scrolling is the controller's free-running HORIZSCROLL over a
+   band of rows. Display RAM must not be written while it runs, so stop it
+   with stopScroll() before drawing again.
+
+   Only relative vertical scrolling is exported until a screen needs an
+   absolute offset; scrollLines(-getScrollOffset()) returns to the top.
+*/
+/***********************************/
+
+static void setScrollOffset(int line) {
+  line %= SSD1351HEIGHT;
+  if (line < 0) line += SSD1351HEIGHT;
+
+  if (Framebuffer_IsEnabled()) {
+    // Keep the shadow copy in screen coordinates too
+    Framebuffer_Flush();
+    Framebuffer_Scroll(line - g_scrollOffset);
+  }
+
+  g_scrollOffset = line;
+  writeCommand(SSD1351_CMD_STARTLINE);
+  writeData(g_scrollOffset);
+}
+
+void scrollLines(int lines) {
+  setScrollOffset(g_scrollOffset + lines);
+}
+
+int getScrollOffset(void) {
+  return g_scrollOffset;
+}
+
+void startHorizontalScroll(int top, int rows, int columns, int speed) {
+  unsigned char step;
+
+  if (top < 0) top = 0;
+  if (top >= SSD1351HEIGHT) top = SSD1351HEIGHT - 1;
+  if (rows > SSD1351HEIGHT - top) rows = SSD1351HEIGHT - top;
+  if (rows < 1) rows = 1;
+
+  if (columns > 63) columns = 63;
+  if (columns < -63) columns = -63;
+
+  // 1..63 scrolls towards column 127, 64..255 towards column 0
+  step = (columns >= 0) ? columns : (256 + columns);
+
+  writeCommand(SSD1351_CMD_HORIZSCROLL);
+  writeData(step);
+  writeData((top + g_scrollOffset) % SSD1351HEIGHT);
+  writeData(rows);
+  writeData(0x00);
+  writeData(speed & 0x03);
+  writeCommand(SSD1351_CMD_STARTSCROLL);
+}
+
+void stopScroll(void) {
+  writeCommand(SSD1351_CMD_STOPSCROLL);
+}
+
 /***********************************/
 
 void goTo(int x, int y) {
@@ -159,7 +551,7 @@ void goTo(int x, int y) {
   writeData(SSD1351WIDTH-1);
 
   writeCommand(SSD1351_CMD_SETROW);
-  writeData(y);
+  writeData((y + g_scrollOffset) % SSD1351HEIGHT);
   writeData(SSD1351HEIGHT-1);
 
   writeCommand(SSD1351_CMD_WRITERAM);
@@ -180,6 +572,15 @@ void fillScreen(unsigned int fillcolor) {
   fillRect(0, 0, SSD1351WIDTH, SSD1351HEIGHT, fillcolor);
 }
 
+// Clip a rectangle to the screen, returns false if nothing is left to draw
+static bool clipRect(int *x, int *y, int *w, int *h) {
+  if (*x < 0) { *w += *x; *x = 0; }
+  if (*y < 0) { *h += *y; *y = 0; }
+  if (*x + *w > SSD1351WIDTH) *w = SSD1351WIDTH - *x;
+  if (*y + *h > SSD1351HEIGHT) *h = SSD1351HEIGHT - *y;
+  return (*w > 0) && (*h > 0);
+}
+
 /**************************************************************************/
 /*!
     @brief  Draws a filled rectangle using HW acceleration
@@ -187,175 +588,191 @@ void fillScreen(unsigned int fillcolor) {
 /**************************************************************************/
 void fillRect(unsigned int x, unsigned int y, unsigned int w, unsigned int h, unsigned int fillcolor)
 {
-  unsigned int i;
+  int cx = x, cy = y, cw = w, ch = h;
 
-  // Bounds check
-  if ((x >= SSD1351WIDTH) || (y >= SSD1351HEIGHT))
+  if (Framebuffer_IsEnabled()) {
+    Framebuffer_FillRect(x, y, w, h, fillcolor);
     return;
-
-  // Y bounds check
-  if (y+h > SSD1351HEIGHT)
-  {
-    h = SSD1351HEIGHT - y - 1;
   }
 
-  // X bounds check
-  if (x+w > SSD1351WIDTH)
-  {
-    w = SSD1351WIDTH - x - 1;
-  }
-
-  // set location
-  writeCommand(SSD1351_CMD_SETCOLUMN);
-  writeData(x);
-  writeData(x+w-1);
-  writeCommand(SSD1351_CMD_SETROW);
-  writeData(y);
-  writeData(y+h-1);
-  // fill!
-  writeCommand(SSD1351_CMD_WRITERAM);
+  if (!clipRect(&cx, &cy, &cw, &ch))
+    return;
 
-  for (i=0; i < w*h; i++) {
-    writeData(fillcolor >> 8);
-    writeData(fillcolor);
-  }
+  STATS_BEGIN(OLED_PRIM_RECT);
+  beginWindow(cx, cy, cw, ch);
+  pushColor(fillcolor, (unsigned long)cw * ch);
+  endWindow();
+  STATS_END();
 }
 
 void drawFastVLine(int x, int y, int h, unsigned int color) {
+  int w = 1;
 
-  unsigned int i;
-  // Bounds check
-  if ((x >= SSD1351WIDTH) || (y >= SSD1351HEIGHT))
+  if (Framebuffer_IsEnabled()) {
+    Framebuffer_FillRect(x, y, 1, h, color);
     return;
-
-  // X bounds check
-  if (y+h > SSD1351HEIGHT)
-  {
-    h = SSD1351HEIGHT - y - 1;
   }
 
-  if (h < 0) return;
-
-  // set location
-  writeCommand(SSD1351_CMD_SETCOLUMN);
-  writeData(x);
-  writeData(x);
-  writeCommand(SSD1351_CMD_SETROW);
-  writeData(y);
-  writeData(y+h-1);
-  // fill!
-  writeCommand(SSD1351_CMD_WRITERAM);
+  if (!clipRect(&x, &y, &w, &h))
+    return;
 
-  for (i=0; i < h; i++) {
-    writeData(color >> 8);
-    writeData(color);
-  }
+  STATS_BEGIN(OLED_PRIM_VLINE);
+  beginWindow(x, y, 1, h);
+  pushColor(color, h);
+  endWindow();
+  STATS_END();
 }
 
 
 
 void drawFastHLine(int x, int y, int w, unsigned int color) {
+  int h = 1;
 
-  unsigned int i;
-  // Bounds check
-  if ((x >= SSD1351WIDTH) || (y >= SSD1351HEIGHT))
+  if (Framebuffer_IsEnabled()) {
+    Framebuffer_FillRect(x, y, w, 1, color);
     return;
-
-  // X bounds check
-  if (x+w > SSD1351WIDTH)
-  {
-    w = SSD1351WIDTH - x - 1;
   }
 
-  if (w < 0) return;
-
-  // set location
-  writeCommand(SSD1351_CMD_SETCOLUMN);
-  writeData(x);
-  writeData(x+w-1);
-  writeCommand(SSD1351_CMD_SETROW);
-  writeData(y);
-  writeData(y);
-  // fill!
-  writeCommand(SSD1351_CMD_WRITERAM);
+  if (!clipRect(&x, &y, &w, &h))
+    return;
 
-  for (i=0; i < w; i++) {
-    writeData(color >> 8);
-    writeData(color);
-  }
+  STATS_BEGIN(OLED_PRIM_HLINE);
+  beginWindow(x, y, w, 1);
+  pushColor(color, w);
+  endWindow();
+  STATS_END();
 }
 
 
 void fastFillScreen(unsigned int fillcolor) {
-  // Calculate total number of pixels
-  unsigned int totalPixels = SSD1351WIDTH * SSD1351HEIGHT;
-  unsigned char colorHigh = fillcolor >> 8;
-  unsigned char colorLow = fillcolor & 0xFF;
+  if (Framebuffer_IsEnabled()) {
+    Framebuffer_FillRect(0, 0, SSD1351WIDTH, SSD1351HEIGHT, fillcolor);
+    return;
+  }
 
-  // Set the entire display as our active area
-  writeCommand(SSD1351_CMD_SETCOLUMN);
-  writeData(0);
-  writeData(SSD1351WIDTH-1);
-  writeCommand(SSD1351_CMD_SETROW);
-  writeData(0);
-  writeData(SSD1351HEIGHT-1);
+  // Set the entire display as our active area and send every pixel
+  // in a single CS-active session
+  STATS_BEGIN(OLED_PRIM_FILLSCREEN);
+  beginWindow(0, 0, SSD1351WIDTH, SSD1351HEIGHT);
+  pushColor(fillcolor, (unsigned long)SSD1351WIDTH * SSD1351HEIGHT);
+  endWindow();
+  STATS_END();
+}
 
-  // Start the RAM write operation
-  writeCommand(SSD1351_CMD_WRITERAM);
+/**************************************************************************/
+/*
+   1bpp expansion lookup table
 
-  // Keep DC high for data and hold CS low for the entire transfer
-  GPIOPinWrite(GPIOA3_BASE, 0x10, 0xff); // DC high for data
-  MAP_SPICSEnable(GSPI_BASE);            // Enable CS
-  GPIOPinWrite(GPIOA1_BASE, 0x80, 0x00); // OLEDCS low
+   One 8-pixel RGB565 span per possible source byte for the current
+   foreground/background pair. It is rebuilt only when the pair changes, so
+   a run of frames in the same colors expands each row with one table read
+   per byte and no per-bit tests.
+*/
+/**************************************************************************/
+static uint16_t g_spanLut[256][8];
+static uint16_t g_spanColor;
+static uint16_t g_spanBgColor;
+static bool g_spanValid = false;
+static uint16_t g_spanRow[SSD1351WIDTH];
+
+static void buildSpanLut(uint16_t color, uint16_t bg_color) {
+  int b, bit;
+
+  for (b = 0; b < 256; b++) {
+    for (bit = 0; bit < 8; bit++) {
+      g_spanLut[b][bit] = (b & (0x80 >> bit)) ? color : bg_color;
+    }
+  }
 
-  // Send all pixels in a single CS-active session
-  unsigned int i;
-  for (i = 0; i < totalPixels; i++) {
-    // Send high byte
-    MAP_SPIDataPut(GSPI_BASE, colorHigh);
-    MAP_SPIDataGet(GSPI_BASE, &flush);
+  g_spanColor = color;
+  g_spanBgColor = bg_color;
+  g_spanValid = true;
+}
 
-    // Send low byte
-    MAP_SPIDataPut(GSPI_BASE, colorLow);
-    MAP_SPIDataGet(GSPI_BASE, &flush);
-  }
+// Expand one source row into g_spanRow, scaled horizontally by pixelSize
+static void expandSpanRow(const uint8_t *src, int width, int pixelSize) {
+  uint16_t *dst = g_spanRow;
+  int fullBytes = width >> 3;
+  int i, px;
 
-  // End the transaction
-  GPIOPinWrite(GPIOA1_BASE, 0x80, 0xff); // OLEDCS high
-  MAP_SPICSDisable(GSPI_BASE);           // Disable CS
+  if (pixelSize == 1) {
+    for (i = 0; i < fullBytes; i++) {
+      memcpy(dst, g_spanLut[src[i]], sizeof(g_spanLut[0]));
+      dst += 8;
+    }
+    if (width & 7) {
+      memcpy(dst, g_spanLut[src[fullBytes]], (width & 7) * sizeof(uint16_t));
+    }
+  } else {
+    for (i = 0; i < width; i++) {
+      uint16_t pixel = g_spanLut[src[i >> 3]][i & 7];
+      for (px = 0; px < pixelSize; px++) {
+        *dst++ = pixel;
+      }
+    }
+  }
 }
 
 void fastDrawBitmap(int x, int y, const uint8_t *bitmap, int width, int height, uint16_t color, uint16_t bg_color, int pixelSize) {
     int byteWidth = (width + 7) / 8; // Bytes per row
-    uint16_t colorHigh = color >> 8;
-    uint16_t colorLow = color & 0xFF;
-    uint16_t bgColorHigh = bg_color >> 8;
-    uint16_t bgColorLow = bg_color & 0xFF;
 
     // Calculate the scaled width and height
     int scaledWidth = width * pixelSize;
     int scaledHeight = height * pixelSize;
+    int j, py;
 
-    // Set the drawing window to the scaled size
-    writeCommand(SSD1351_CMD_SETCOLUMN);
-    writeData(x);
-    writeData(x + scaledWidth - 1);
-    writeCommand(SSD1351_CMD_SETROW);
-    writeData(y);
-    writeData(y + scaledHeight - 1);
+    if (Framebuffer_IsEnabled()) {
+        Framebuffer_DrawBitmap(x, y, bitmap, width, height, color, bg_color, pixelSize);
+        return;
+    }
 
-    // Start RAM write
-    writeCommand(SSD1351_CMD_WRITERAM);
+    // Transparent backgrounds go out as runs of set pixels, leaving the
+    // background on screen alone
+    if (bg_color == 1) {
+        drawSprite(x, y, bitmap, width, height, color, pixelSize, 0);
+        return;
+    }
+
+    // Rows wider than the screen take the bit loop
+    if (pixelSize < 1 || scaledWidth > SSD1351WIDTH) {
+        fastDrawBitmapBitwise(x, y, bitmap, width, height, color, bg_color, pixelSize);
+        return;
+    }
+
+    if (!g_spanValid || color != g_spanColor || bg_color != g_spanBgColor) {
+        buildSpanLut(color, bg_color);
+    }
+
+    STATS_BEGIN(OLED_PRIM_BITMAP);
+    beginWindow(x, y, scaledWidth, scaledHeight);
+
+    // Decode each source row once and replicate it pixelSize times
+    for (j = 0; j < height; j++) {
+        expandSpanRow(&bitmap[j * byteWidth], width, pixelSize);
+        for (py = 0; py < pixelSize; py++) {
+            pushPixels(g_spanRow, scaledWidth);
+        }
+    }
+
+    endWindow();
+    STATS_END();
+}
+
+// Per-bit reference path. Opaque only: every pixel of the window is written.
+void fastDrawBitmapBitwise(int x, int y, const uint8_t *bitmap, int width, int height, uint16_t color, uint16_t bg_color, int pixelSize) {
+    int byteWidth = (width + 7) / 8; // Bytes per row
+
+    // Calculate the scaled width and height
+    int scaledWidth = width * pixelSize;
+    int scaledHeight = height * pixelSize;
 
-    // Keep DC high for data and hold CS low for the entire transfer
-    GPIOPinWrite(GPIOA3_BASE, 0x10, 0xff); // DC high for data
-    MAP_SPICSEnable(GSPI_BASE);            // Enable CS
-    GPIOPinWrite(GPIOA1_BASE, 0x80, 0x00); // OLEDCS low
+    // Set the drawing window to the scaled size
+    STATS_BEGIN(OLED_PRIM_BITMAP);
+    beginWindow(x, y, scaledWidth, scaledHeight);
 
     int j = 0;
     int i = 0;
     int py = 0;
-    int px = 0;
     // Process all pixels with scaling
     for ( j = 0; j < height; j++) {
         // Repeat each row pixelSize times
@@ -366,41 +783,194 @@ void fastDrawBitmap(int x, int y, const uint8_t *bitmap, int width, int height,
                 bool isForeground = bitmap[byteIndex] & bitMask;
 
                 // Repeat each pixel horizontally pixelSize times
-                for (px = 0; px < pixelSize; px++) {
-                    if (isForeground) {
-                        // Foreground pixel
-                        MAP_SPIDataPut(GSPI_BASE, colorHigh);
-                        MAP_SPIDataGet(GSPI_BASE, &flush);
-                        MAP_SPIDataPut(GSPI_BASE, colorLow);
-                        MAP_SPIDataGet(GSPI_BASE, &flush);
-                    } else {
-                        if (bg_color != 1) {
-                            // Background pixel
-                            MAP_SPIDataPut(GSPI_BASE, bgColorHigh);
-                            MAP_SPIDataGet(GSPI_BASE, &flush);
-                            MAP_SPIDataPut(GSPI_BASE, bgColorLow);
-                            MAP_SPIDataGet(GSPI_BASE, &flush);
-                        }
+                pushColor(isForeground ? color : bg_color, pixelSize);
+            }
+        }
+    }
+
+    // End the transaction
+    endWindow();
+    STATS_END();
+}
+
+/**************************************************************************/
+/*
+   PackBits bitmaps
+
+   Bytes of 0x00 and 0xFF are merged into one pending run of a single color
+   that goes out as one pushColor() when the color changes, so a blank
+   background costs a handful of fills. Other bytes go out through the span
+   table. Data that ends early leaves the rest of the window background.
+
+   The shadow framebuffer and transparent backgrounds cannot take a window,
+   so there the stream is decoded one row at a time. Transparent rows go
+   through drawSprite(), which leaves background pixels alone; opaque rows
+   go through fastDrawBitmap() into the framebuffer.
+*/
+/**************************************************************************/
+static void drawPackBitsRows(int x, int y, const uint8_t *data, unsigned long length, int width, int height, uint16_t color, uint16_t bg_color) {
+    uint8_t row[SSD1351WIDTH / 8];
+    const uint8_t *end = data + length;
+    int byteWidth = (width + 7) / 8;
+    unsigned long chunkLeft = 0;
+    bool repeat = false;
+    int i, j;
+
+    if (byteWidth > (int)sizeof(row)) {
+        return;
+    }
+
+    for (j = 0; j < height; j++) {
+        for (i = 0; i < byteWidth; i++) {
+            // Next chunk header, skipping no-ops
+            while (chunkLeft == 0 && data < end) {
+                int n = (int8_t)*data++;
+
+                if (n == -128) {
+                    continue;
+                }
+                repeat = (n < 0);
+                chunkLeft = repeat ? (unsigned long)(1 - n) : (unsigned long)(n + 1);
+                if (repeat ? (data >= end) : ((unsigned long)(end - data) < chunkLeft)) {
+                    data = end;     // truncated
+                    chunkLeft = 0;
+                }
+            }
+
+            if (chunkLeft == 0) {
+                row[i] = 0x00;      // past the end of the data: background
+                continue;
+            }
+            row[i] = *data;
+            if (!repeat || chunkLeft == 1) {
+                data++;
+            }
+            chunkLeft--;
+        }
+        if (bg_color == 1) {
+            drawSprite(x, y + j, row, width, 1, color, 1, 0);
+        } else {
+            fastDrawBitmap(x, y + j, row, width, 1, color, bg_color, 1);
+        }
+    }
+}
+
+void fastDrawBitmapPackBits(int x, int y, const uint8_t *data, unsigned long length, int width, int height, uint16_t color, uint16_t bg_color) {
+    const uint8_t *end = data + length;
+    int byteWidth = (width + 7) / 8;
+    int lastBits = (width & 7) ? (width & 7) : 8;   // pixels in a row's last byte
+    unsigned long bytesLeft = (unsigned long)byteWidth * height;
+    unsigned long pixelsLeft = (unsigned long)width * height;
+    unsigned long runPixels = 0;
+    uint16_t runColor = bg_color;
+    int column = 0;
+
+    if (Framebuffer_IsEnabled() || bg_color == 1) {
+        drawPackBitsRows(x, y, data, length, width, height, color, bg_color);
+        return;
+    }
+
+    if (!g_spanValid || color != g_spanColor || bg_color != g_spanBgColor) {
+        buildSpanLut(color, bg_color);
+    }
+
+    STATS_BEGIN(OLED_PRIM_BITMAP);
+    beginWindow(x, y, width, height);
+
+    while (data < end && bytesLeft > 0) {
+        int n = (int8_t)*data++;
+        unsigned long count, k;
+        bool repeat = (n < 0);
+
+        if (n == -128) {
+            continue;
+        }
+        count = repeat ? (unsigned long)(1 - n) : (unsigned long)(n + 1);
+        if (repeat ? (data >= end) : ((unsigned long)(end - data) < count)) {
+            break;  // truncated
+        }
+        if (count > bytesLeft) {
+            count = bytesLeft;
+        }
+
+        if (repeat && (*data == 0x00 || *data == 0xFF) && lastBits == 8) {
+            // Whole bytes of one color: extend the run in one step
+            uint16_t c = *data ? color : bg_color;
+
+            if (runPixels && c != runColor) {
+                pushColor(runColor, runPixels);
+                pixelsLeft -= runPixels;
+                runPixels = 0;
+            }
+            runColor = c;
+            runPixels += count * 8;
+            column = (column + count) % byteWidth;
+        } else {
+            for (k = 0; k < count; k++) {
+                uint8_t b = repeat ? *data : data[k];
+                int bits = (column == byteWidth - 1) ? lastBits : 8;
+
+                if (b == 0x00 || b == 0xFF) {
+                    uint16_t c = b ? color : bg_color;
+
+                    if (runPixels && c != runColor) {
+                        pushColor(runColor, runPixels);
+                        pixelsLeft -= runPixels;
+                        runPixels = 0;
+                    }
+                    runColor = c;
+                    runPixels += bits;
+                } else {
+                    if (runPixels) {
+                        pushColor(runColor, runPixels);
+                        pixelsLeft -= runPixels;
+                        runPixels = 0;
                     }
+                    pushPixels(g_spanLut[b], bits);
+                    pixelsLeft -= bits;
+                }
+                if (++column == byteWidth) {
+                    column = 0;
                 }
             }
         }
+
+        data += repeat ? 1 : count;
+        bytesLeft -= count;
     }
 
-    // End the transaction
-    GPIOPinWrite(GPIOA1_BASE, 0x80, 0xff); // OLEDCS high
-    MAP_SPICSDisable(GSPI_BASE);           // Disable CS
+    if (runPixels) {
+        pushColor(runColor, runPixels);
+        pixelsLeft -= runPixels;
+    }
+    if (pixelsLeft) {
+        pushColor(bg_color, pixelsLeft);
+    }
+
+    endWindow();
+    STATS_END();
 }
 
 void drawPixel(int x, int y, unsigned int color)
 {
+  if (Framebuffer_IsEnabled()) {
+    Framebuffer_SetPixel(x, y, color);
+    return;
+  }
+
+  if (PixelBatch_IsActive()) {
+    PixelBatch_Add(x, y, color);
+    return;
+  }
+
   if ((x >= SSD1351WIDTH) || (y >= SSD1351HEIGHT)) return;
   if ((x < 0) || (y < 0)) return;
 
-  goTo(x, y);
-
-  writeData(color >> 8);
-  writeData(color);
+  STATS_BEGIN(OLED_PRIM_PIXEL);
+  beginWindow(x, y, 1, 1);
+  pushColor(color, 1);
+  endWindow();
+  STATS_END();
 }
 
 
@@ -412,4 +982,36 @@ void  invert(char v) {
    }
  }
 
+#if SSD1351_STATS
+/***********************************/
+/*
+   Bus statistics, one entry per drawing primitive. Bytes and chip-select
+   assertions issued outside the primitives below are booked as "other".
+*/
+/***********************************/
+
+static const char * const g_primNames[OLED_PRIM_COUNT] = {
+  "other", "drawPixel", "drawFastHLine", "drawFastVLine",
+  "fillRect", "fastFillScreen", "fastDrawBitmap"
+};
+
+void resetDisplayStats(void) {
+  memset(g_displayStats, 0, sizeof(g_displayStats));
+}
+
+const DisplayStats* getDisplayStats(int prim) {
+  if ((prim < 0) || (prim >= OLED_PRIM_COUNT)) return 0;
+  return &g_displayStats[prim];
+}
+
+void reportDisplayStats(void) {
+  int i;
+  Report("%-16s %8s %10s %8s %10s\n\r", "primitive", "calls", "bytes", "CS", "bytes/call");
+  for (i = 0; i < OLED_PRIM_COUNT; i++) {
+    const DisplayStats *s = &g_displayStats[i];
+    Report("%-16s %8lu %10lu %8lu %10lu\n\r", g_primNames[i], s->calls, s->bytes,
+           s->transactions, s->calls ? s->bytes / s->calls : 0);
+  }
+}
+#endif // SSD1351_STATS
 
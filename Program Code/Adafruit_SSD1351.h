@@ -16,6 +16,9 @@
   BSD license, all text above must be included in any redistribution
  ****************************************************/
 
+#ifndef ADAFRUIT_SSD1351_H_
+#define ADAFRUIT_SSD1351_H_
+
 #define SSD1351WIDTH 128
 #define SSD1351HEIGHT 128  // SET THIS TO 96 FOR 1.27"!
 #include <stdint.h>
@@ -46,6 +49,17 @@
   #error "RGB and BGR can not both be defined for SSD1351_COLORODER."
 #endif
 
+// Set to 1 to count SPI bytes and chip-select assertions per drawing primitive
+#ifndef SSD1351_STATS
+#define SSD1351_STATS 0
+#endif
+
+// SPI word length used for the pixel data phase of WRITERAM: 8, 16 or 32.
+// Commands always go out as 8-bit words.
+#ifndef SSD1351_SPI_WORD_BITS
+#define SSD1351_SPI_WORD_BITS 32
+#endif
+
 // Timing Delays
 #define SSD1351_DELAYS_HWFILL	    (3)
 #define SSD1351_DELAYS_HWLINE       (1)
@@ -104,6 +118,26 @@ class Adafruit_SSD1351  : public virtual Adafruit_GFX {
   void fillScreen(unsigned int fillcolor);
   void fastFillScreen(unsigned int fillcolor);
   void fastDrawBitmap(int x, int y, const uint8_t *bitmap, int width, int height, uint16_t color, uint16_t bg_color, int pixelSize);
+  void fastDrawBitmapBitwise(int x, int y, const uint8_t *bitmap, int width, int height, uint16_t color, uint16_t bg_color, int pixelSize);
+
+  // PackBits-coded 1bpp bitmap (see packbits.h), unscaled, decoded straight
+  // into the window. With the shadow framebuffer enabled or a transparent
+  // background (bg_color == 1) it is decoded row by row and drawn through
+  // fastDrawBitmap() or drawSprite() instead.
+  void fastDrawBitmapPackBits(int x, int y, const uint8_t *data, unsigned long length, int width, int height, uint16_t color, uint16_t bg_color);
+
+  // streaming pixel window, x/y/w/h must already be on screen
+  void beginWindow(int x, int y, int w, int h);
+  void pushColor(unsigned int color, unsigned long n);
+  void pushPixels(const uint16_t *buf, unsigned long n);
+  void endWindow(void);
+
+  // hardware scrolling, drawing coordinates follow the vertical offset;
+  // horizontal scrolling moves rows top..top+rows-1 until stopScroll()
+  void scrollLines(int lines);
+  int getScrollOffset(void);
+  void startHorizontalScroll(int top, int rows, int columns, int speed);
+  void stopScroll(void);
 
   void invert(char);
   // commands
@@ -131,3 +165,28 @@ class Adafruit_SSD1351  : public virtual Adafruit_GFX {
   PortReg *csport, *rsport, *sidport, *sclkport;
   PortMask cspinmask, rspinmask, sidpinmask, sclkpinmask;
 */
+
+#if SSD1351_STATS
+enum {
+  OLED_PRIM_OTHER,
+  OLED_PRIM_PIXEL,
+  OLED_PRIM_HLINE,
+  OLED_PRIM_VLINE,
+  OLED_PRIM_RECT,
+  OLED_PRIM_FILLSCREEN,
+  OLED_PRIM_BITMAP,
+  OLED_PRIM_COUNT
+};
+
+typedef struct {
+  unsigned long calls;
+  unsigned long bytes;
+  unsigned long transactions;   // chip-select assertions
+} DisplayStats;
+
+  void resetDisplayStats(void);
+  void reportDisplayStats(void);
+  const DisplayStats* getDisplayStats(int prim);
+#endif
+
+#endif /* ADAFRUIT_SSD1351_H_ */
@@ -0,0 +1,267 @@
+//*****************************************************************************
+// Accelerometer Filters
+// See accel_filter.h for an overview.
+//*****************************************************************************
+
+// Standard includes
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "simplelink.h"
+
+#include "accel_filter.h"
+
+#if ACCEL_FILTER_BENCHMARK
+#include "systick.h"
+#include "uart_if.h"
+#endif
+
+#define SUCCESS                 0
+#define FAILURE                 -1
+
+#define IIR_MIN_SHIFT           1
+#define IIR_MAX_SHIFT           8
+
+// Calibration record as stored in flash
+#define CAL_MAGIC               0x4C414341UL    // "ACAL"
+
+typedef struct {
+    uint32_t magic;
+    int16_t offsets[3];
+    int16_t reserved;
+} CalibrationRecord;
+
+//*****************************************************************************
+// Global Variables
+//*****************************************************************************
+static int16_t g_calOffsets[3] = {0, 0, 0};
+
+//*****************************************************************************
+// Helpers
+//*****************************************************************************
+
+// Median of count values, sorting a copy by insertion (count is small)
+static int32_t Median(const int32_t *values, int count)
+{
+    int32_t sorted[ACCEL_FILTER_MAX_WINDOW];
+    int i, j;
+
+    for (i = 0; i < count; i++) {
+        int32_t v = values[i];
+
+        for (j = i; j > 0 && sorted[j - 1] > v; j--) {
+            sorted[j] = sorted[j - 1];
+        }
+        sorted[j] = v;
+    }
+
+    if (count & 1) {
+        return sorted[count / 2];
+    }
+    return (sorted[count / 2 - 1] + sorted[count / 2]) / 2;
+}
+
+//*****************************************************************************
+// Public API
+//*****************************************************************************
+void AccelFilter_Init(AccelFilter *filter, AccelFilterType type, int param)
+{
+    int minParam = (type == ACCEL_FILTER_IIR) ? IIR_MIN_SHIFT : 1;
+    int maxParam = (type == ACCEL_FILTER_IIR) ? IIR_MAX_SHIFT : ACCEL_FILTER_MAX_WINDOW;
+
+    if (param < minParam) param = minParam;
+    if (param > maxParam) param = maxParam;
+
+    filter->type = type;
+    filter->param = param;
+    AccelFilter_Reset(filter);
+}
+
+void AccelFilter_Reset(AccelFilter *filter)
+{
+    filter->count = 0;
+    filter->next = 0;
+    memset(filter->state, 0, sizeof(filter->state));
+    memset(filter->window, 0, sizeof(filter->window));
+}
+
+void AccelFilter_Update(AccelFilter *filter, const AccelSample *sample, int32_t out[3])
+{
+    int32_t in[3];
+    int axis;
+
+    in[0] = ((int32_t)sample->x << ACCEL_FILTER_SHIFT) - g_calOffsets[0];
+    in[1] = ((int32_t)sample->y << ACCEL_FILTER_SHIFT) - g_calOffsets[1];
+    in[2] = ((int32_t)sample->z << ACCEL_FILTER_SHIFT) - g_calOffsets[2];
+
+    switch (filter->type) {
+    case ACCEL_FILTER_IIR:
+        for (axis = 0; axis < 3; axis++) {
+            if (filter->count == 0) {
+                filter->state[axis] = in[axis];
+            } else {
+                filter->state[axis] += (in[axis] - filter->state[axis]) >> filter->param;
+            }
+            out[axis] = filter->state[axis];
+        }
+        filter->count = 1;
+        break;
+
+    case ACCEL_FILTER_MOVING_AVERAGE:
+        for (axis = 0; axis < 3; axis++) {
+            // The slot about to be overwritten drops out of the sum
+            filter->state[axis] += in[axis] - filter->window[axis][filter->next];
+            filter->window[axis][filter->next] = in[axis];
+        }
+        if (filter->count < filter->param) {
+            filter->count++;
+        }
+        for (axis = 0; axis < 3; axis++) {
+            out[axis] = filter->state[axis] / filter->count;
+        }
+        filter->next = (filter->next + 1 == filter->param) ? 0 : filter->next + 1;
+        break;
+
+    case ACCEL_FILTER_MEDIAN:
+        for (axis = 0; axis < 3; axis++) {
+            filter->window[axis][filter->next] = in[axis];
+        }
+        if (filter->count < filter->param) {
+            filter->count++;
+        }
+        for (axis = 0; axis < 3; axis++) {
+            out[axis] = Median(filter->window[axis], filter->count);
+        }
+        filter->next = (filter->next + 1 == filter->param) ? 0 : filter->next + 1;
+        break;
+
+    default:
+        out[0] = in[0];
+        out[1] = in[1];
+        out[2] = in[2];
+        break;
+    }
+}
+
+void AccelFilter_SetCalibration(const int16_t offsets[3])
+{
+    g_calOffsets[0] = offsets[0];
+    g_calOffsets[1] = offsets[1];
+    g_calOffsets[2] = offsets[2];
+}
+
+void AccelFilter_GetCalibration(int16_t offsets[3])
+{
+    offsets[0] = g_calOffsets[0];
+    offsets[1] = g_calOffsets[1];
+    offsets[2] = g_calOffsets[2];
+}
+
+void AccelFilter_CalibrateFlat(const int32_t averageQ8[3])
+{
+    g_calOffsets[0] = (int16_t)averageQ8[0];
+    g_calOffsets[1] = (int16_t)averageQ8[1];
+    g_calOffsets[2] = (int16_t)(averageQ8[2] - (ACCEL_FILTER_ONE_G << ACCEL_FILTER_SHIFT));
+}
+
+int AccelFilter_LoadCalibration(void)
+{
+    CalibrationRecord record;
+    long fileHandle;
+    long bytesRead;
+
+    if (sl_FsOpen((unsigned char*)ACCEL_FILTER_CAL_FILE, FS_MODE_OPEN_READ, NULL, &fileHandle) < 0) {
+        return FAILURE;
+    }
+    bytesRead = sl_FsRead(fileHandle, 0, (unsigned char*)&record, sizeof(record));
+    sl_FsClose(fileHandle, 0, 0, 0);
+
+    if (bytesRead != (long)sizeof(record) || record.magic != CAL_MAGIC) {
+        return FAILURE;
+    }
+
+    AccelFilter_SetCalibration(record.offsets);
+    return SUCCESS;
+}
+
+int AccelFilter_SaveCalibration(void)
+{
+    CalibrationRecord record;
+    long fileHandle;
+    long bytesWritten;
+
+    record.magic = CAL_MAGIC;
+    AccelFilter_GetCalibration(record.offsets);
+    record.reserved = 0;
+
+    // Overwrite the file if it exists, create it otherwise
+    if (sl_FsOpen((unsigned char*)ACCEL_FILTER_CAL_FILE, FS_MODE_OPEN_WRITE, NULL, &fileHandle) < 0 &&
+        sl_FsOpen((unsigned char*)ACCEL_FILTER_CAL_FILE,
+                  FS_MODE_OPEN_CREATE(sizeof(record), _FS_FILE_OPEN_FLAG_COMMIT),
+                  NULL, &fileHandle) < 0) {
+        return FAILURE;
+    }
+    bytesWritten = sl_FsWrite(fileHandle, 0, (unsigned char*)&record, sizeof(record));
+    sl_FsClose(fileHandle, 0, 0, 0);
+
+    return (bytesWritten == (long)sizeof(record)) ? SUCCESS : FAILURE;
+}
+
+#if ACCEL_FILTER_BENCHMARK
+//*****************************************************************************
+// Benchmark
+// A noisy tilt ramp goes through each filter; SysTick counts down at 80MHz.
+//*****************************************************************************
+#define BENCH_SAMPLES           256
+
+static volatile int32_t g_benchSink;
+
+void AccelFilter_Benchmark(void)
+{
+    static const struct {
+        const char *label;
+        AccelFilterType type;
+        int param;
+    } kinds[] = {
+        {"none",       ACCEL_FILTER_NONE,           0},
+        {"iir k=3",    ACCEL_FILTER_IIR,            3},
+        {"average 4",  ACCEL_FILTER_MOVING_AVERAGE, 4},
+        {"average 8",  ACCEL_FILTER_MOVING_AVERAGE, 8},
+        {"median 3",   ACCEL_FILTER_MEDIAN,         3},
+        {"median 5",   ACCEL_FILTER_MEDIAN,         5},
+        {"median 9",   ACCEL_FILTER_MEDIAN,         9}
+    };
+    AccelSample trace[BENCH_SAMPLES];
+    AccelFilter filter;
+    int32_t out[3];
+    unsigned long start;
+    unsigned int k;
+    int i;
+
+    for (i = 0; i < BENCH_SAMPLES; i++) {
+        int noise = ((i * 37) % 11) - 5;
+
+        trace[i].x = (int8_t)(i / 4 - 32 + noise);
+        trace[i].y = (int8_t)(16 - noise);
+        trace[i].z = (int8_t)(60 + noise / 2);
+    }
+
+    SysTickDisable();
+    SysTickIntDisable();
+    SysTickPeriodSet(0xFFFFFF);
+    SysTickEnable();
+
+    for (k = 0; k < sizeof(kinds) / sizeof(kinds[0]); k++) {
+        AccelFilter_Init(&filter, kinds[k].type, kinds[k].param);
+
+        start = SysTickValueGet();
+        for (i = 0; i < BENCH_SAMPLES; i++) {
+            AccelFilter_Update(&filter, &trace[i], out);
+            g_benchSink = out[0];
+        }
+        Report("%-10s %lu cycles/sample\n\r", kinds[k].label,
+               ((start - SysTickValueGet()) & 0xFFFFFF) / BENCH_SAMPLES);
+    }
+}
+#endif // ACCEL_FILTER_BENCHMARK
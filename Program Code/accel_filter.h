@@ -0,0 +1,101 @@
+//*****************************************************************************
+// Accelerometer Filters
+// Per-consumer smoothing of the BMA222 sample stream, all in integer math.
+// Each consumer owns an AccelFilter and picks its kind:
+//   IIR             y += (x - y) / 2^k, one add and shift per axis. Smooth
+//                   but lags about 2^k samples.
+//   Moving average  mean of the last N samples. Flat response, N-sample lag.
+//   Median          median of the last N samples per axis. Rejects single
+//                   spikes without blurring a real step.
+// Samples have the calibration offsets subtracted first. Outputs are Q8
+// counts (256 per raw count, about 64 raw counts per g).
+//
+// The filters only depend on accel_sampler.h for the sample type, so they
+// can run on recorded traces off target. Only the calibration load/save
+// below touch SimpleLink.
+//*****************************************************************************
+
+#ifndef ACCEL_FILTER_H_
+#define ACCEL_FILTER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "accel_sampler.h"
+
+#define ACCEL_FILTER_SHIFT          8
+#define ACCEL_FILTER_ONE            (1 << ACCEL_FILTER_SHIFT)
+
+// Longest moving average or median window
+#define ACCEL_FILTER_MAX_WINDOW     9
+
+// Raw reading of 1g on the axis that points up when the board lies flat
+#define ACCEL_FILTER_ONE_G          64
+
+// Calibration file in the SimpleLink file system
+#define ACCEL_FILTER_CAL_FILE       "/accel_cal.bin"
+
+// Set to 1 to build AccelFilter_Benchmark()
+#ifndef ACCEL_FILTER_BENCHMARK
+#define ACCEL_FILTER_BENCHMARK      0
+#endif
+
+typedef enum {
+    ACCEL_FILTER_NONE,              // calibrated pass-through
+    ACCEL_FILTER_IIR,               // param: k in 1/2^k (1 to 8)
+    ACCEL_FILTER_MOVING_AVERAGE,    // param: window (1 to ACCEL_FILTER_MAX_WINDOW)
+    ACCEL_FILTER_MEDIAN             // param: window (1 to ACCEL_FILTER_MAX_WINDOW)
+} AccelFilterType;
+
+typedef struct {
+    AccelFilterType type;
+    int param;
+    int count;                      // samples in the window so far
+    int next;                       // window slot the next sample goes in
+    int32_t state[3];               // IIR output or moving average sum, Q8
+    int32_t window[3][ACCEL_FILTER_MAX_WINDOW];    // recent inputs, Q8
+} AccelFilter;
+
+//*****************************************************************************
+// Set a filter up, clamping param to its valid range. The first sample
+// after this (or AccelFilter_Reset()) passes straight through.
+//*****************************************************************************
+void AccelFilter_Init(AccelFilter *filter, AccelFilterType type, int param);
+void AccelFilter_Reset(AccelFilter *filter);
+
+//*****************************************************************************
+// Feed one raw sample and get the filtered, calibrated reading (Q8 counts)
+//*****************************************************************************
+void AccelFilter_Update(AccelFilter *filter, const AccelSample *sample, int32_t out[3]);
+
+//*****************************************************************************
+// Per-axis offsets (Q8 counts) subtracted from every sample by all filters
+//*****************************************************************************
+void AccelFilter_SetCalibration(const int16_t offsets[3]);
+void AccelFilter_GetCalibration(int16_t offsets[3]);
+
+//*****************************************************************************
+// Derive the offsets from the average of readings taken with the board at
+// rest and flat: X and Y should read 0, Z should read ACCEL_FILTER_ONE_G.
+// averageQ8 is that average in Q8 counts. The cube app does this when
+// button 1 is held, then saves the result.
+//*****************************************************************************
+void AccelFilter_CalibrateFlat(const int32_t averageQ8[3]);
+
+//*****************************************************************************
+// Load or store the offsets in ACCEL_FILTER_CAL_FILE. Loading keeps the
+// current offsets if the file is missing or not a calibration record.
+// Return 0, or -1 on a file system error.
+//*****************************************************************************
+int AccelFilter_LoadCalibration(void);
+int AccelFilter_SaveCalibration(void);
+
+#if ACCEL_FILTER_BENCHMARK
+//*****************************************************************************
+// Time AccelFilter_Update() for each filter kind with SysTick and print the
+// cycles per sample over UART
+//*****************************************************************************
+void AccelFilter_Benchmark(void);
+#endif
+
+#endif /* ACCEL_FILTER_H_ */
@@ -0,0 +1,238 @@
+//*****************************************************************************
+// BMA222 Accelerometer Sampler
+// See accel_sampler.h for an overview.
+//
+// Samples are packed into one 32-bit word each, so a slot is always written
+// and read in a single access. The interrupt fills the slot and then bumps
+// g_writeCount; a reader that preempted nothing can tell from how far the
+// count moved whether the slots it copied were overwritten in the meantime.
+//*****************************************************************************
+
+// Standard includes
+#include <stdint.h>
+#include <stdbool.h>
+
+// Driverlib includes
+#include "hw_types.h"
+#include "hw_memmap.h"
+#include "hw_ints.h"
+#include "interrupt.h"
+#include "timer.h"
+#include "prcm.h"
+#include "rom.h"
+#include "rom_map.h"
+
+// Common interface includes
+#include "i2c_if.h"
+
+#include "accel_sampler.h"
+
+#define SUCCESS                 0
+#define FAILURE                 -1
+
+#define SYSTEM_CLOCK_HZ         80000000UL
+
+// BMA222 address and the first data register; 0x02-0x07 hold X, Y and Z as
+// (LSB, MSB) pairs and the 8-bit reading is in each MSB
+#define ACCEL_I2C_ADDR          0x18
+#define ACCEL_REG_DATA          0x02
+#define ACCEL_DATA_BYTES        6
+
+#define RING_MASK               (ACCEL_SAMPLER_BUFFER_SIZE - 1)
+
+//*****************************************************************************
+// Global Variables
+//*****************************************************************************
+static volatile uint32_t g_ring[ACCEL_SAMPLER_BUFFER_SIZE];
+static volatile unsigned long g_writeCount = 0;    // samples ever written
+static volatile unsigned long g_errorCount = 0;
+static bool g_running = false;
+
+//*****************************************************************************
+// Helpers
+//*****************************************************************************
+static uint32_t PackSample(const AccelSample *sample)
+{
+    return (uint32_t)(uint8_t)sample->x |
+           ((uint32_t)(uint8_t)sample->y << 8) |
+           ((uint32_t)(uint8_t)sample->z << 16);
+}
+
+static void UnpackSample(uint32_t packed, AccelSample *sample)
+{
+    sample->x = (int8_t)(packed & 0xFF);
+    sample->y = (int8_t)((packed >> 8) & 0xFF);
+    sample->z = (int8_t)((packed >> 16) & 0xFF);
+}
+
+// Round-to-nearest division for the average, either sign
+static int8_t RoundedAverage(int sum, int count)
+{
+    return (int8_t)((sum >= 0) ? (sum + count / 2) / count : -((-sum + count / 2) / count));
+}
+
+static void AccelSamplerIntHandler(void)
+{
+    AccelSample sample;
+
+    MAP_TimerIntClear(TIMERA1_BASE, TIMER_TIMA_TIMEOUT);
+
+    if (AccelSampler_ReadBurst(&sample) == SUCCESS) {
+        g_ring[g_writeCount & RING_MASK] = PackSample(&sample);
+        g_writeCount++;
+    } else {
+        g_errorCount++;
+    }
+}
+
+//*****************************************************************************
+// Public API
+//*****************************************************************************
+int AccelSampler_ReadBurst(AccelSample *sample)
+{
+    unsigned char ucReg = ACCEL_REG_DATA;
+    unsigned char ucData[ACCEL_DATA_BYTES];
+
+    // Register write, repeated start, then all six data registers at once
+    if (I2C_IF_ReadFrom(ACCEL_I2C_ADDR, &ucReg, 1, ucData, ACCEL_DATA_BYTES) != SUCCESS) {
+        return FAILURE;
+    }
+
+    sample->x = (int8_t)ucData[1];
+    sample->y = (int8_t)ucData[3];
+    sample->z = (int8_t)ucData[5];
+    return SUCCESS;
+}
+
+void AccelSampler_Start(unsigned long rateHz)
+{
+    if (rateHz < ACCEL_SAMPLER_MIN_RATE_HZ) rateHz = ACCEL_SAMPLER_MIN_RATE_HZ;
+    if (rateHz > ACCEL_SAMPLER_MAX_RATE_HZ) rateHz = ACCEL_SAMPLER_MAX_RATE_HZ;
+
+    if (g_running) {
+        MAP_TimerDisable(TIMERA1_BASE, TIMER_A);
+    } else {
+        MAP_PRCMPeripheralClkEnable(PRCM_TIMERA1, PRCM_RUN_MODE_CLK);
+        MAP_PRCMPeripheralReset(PRCM_TIMERA1);
+        MAP_TimerConfigure(TIMERA1_BASE, TIMER_CFG_PERIODIC);
+        MAP_TimerIntRegister(TIMERA1_BASE, TIMER_A, AccelSamplerIntHandler);
+
+        // Below the buttons, so a slow burst never delays them
+        MAP_IntPrioritySet(INT_TIMERA1A, INT_PRIORITY_LVL_5);
+        MAP_TimerIntEnable(TIMERA1_BASE, TIMER_TIMA_TIMEOUT);
+    }
+
+    // Timer stopped: safe to empty the ring
+    g_writeCount = 0;
+    g_errorCount = 0;
+
+    MAP_TimerLoadSet(TIMERA1_BASE, TIMER_A, SYSTEM_CLOCK_HZ / rateHz);
+    MAP_TimerEnable(TIMERA1_BASE, TIMER_A);
+    g_running = true;
+}
+
+void AccelSampler_Stop(void)
+{
+    if (!g_running) {
+        return;
+    }
+
+    MAP_TimerDisable(TIMERA1_BASE, TIMER_A);
+    MAP_TimerIntDisable(TIMERA1_BASE, TIMER_TIMA_TIMEOUT);
+    MAP_TimerIntClear(TIMERA1_BASE, TIMER_TIMA_TIMEOUT);
+    MAP_TimerIntUnregister(TIMERA1_BASE, TIMER_A);
+    g_running = false;
+}
+
+bool AccelSampler_IsRunning(void)
+{
+    return g_running;
+}
+
+bool AccelSampler_GetLatest(AccelSample *sample)
+{
+    unsigned long count;
+    uint32_t packed;
+
+    do {
+        count = g_writeCount;
+        if (count == 0) {
+            return false;
+        }
+        packed = g_ring[(count - 1) & RING_MASK];
+
+        // The slot is only reused by the ACCEL_SAMPLER_BUFFER_SIZE'th
+        // sample after it
+    } while (g_writeCount - count >= ACCEL_SAMPLER_BUFFER_SIZE);
+
+    UnpackSample(packed, sample);
+    return true;
+}
+
+int AccelSampler_GetAverage(AccelSample *sample, int count)
+{
+    unsigned long end;
+    int sumX, sumY, sumZ;
+    int i;
+
+    if (count > ACCEL_SAMPLER_BUFFER_SIZE) count = ACCEL_SAMPLER_BUFFER_SIZE;
+
+    do {
+        end = g_writeCount;
+        if (count > (int)end) count = (int)end;
+        if (count <= 0) {
+            return 0;
+        }
+
+        sumX = sumY = sumZ = 0;
+        for (i = 1; i <= count; i++) {
+            AccelSample s;
+
+            UnpackSample(g_ring[(end - i) & RING_MASK], &s);
+            sumX += s.x;
+            sumY += s.y;
+            sumZ += s.z;
+        }
+
+        // Retry if the oldest slot we summed may have been overwritten
+    } while (g_writeCount - end + count > ACCEL_SAMPLER_BUFFER_SIZE);
+
+    sample->x = RoundedAverage(sumX, count);
+    sample->y = RoundedAverage(sumY, count);
+    sample->z = RoundedAverage(sumZ, count);
+    return count;
+}
+
+int AccelSampler_ReadNew(unsigned long *cursor, AccelSample *samples, int max)
+{
+    unsigned long end, start, pending;
+    int n, i;
+
+    do {
+        end = g_writeCount;
+        pending = end - *cursor;
+        if (pending > ACCEL_SAMPLER_BUFFER_SIZE) {
+            // Lapped, or the count was reset under us
+            pending = (end < ACCEL_SAMPLER_BUFFER_SIZE) ? end : ACCEL_SAMPLER_BUFFER_SIZE;
+        }
+        start = end - pending;
+        n = (pending < (unsigned long)max) ? (int)pending : max;
+
+        for (i = 0; i < n; i++) {
+            UnpackSample(g_ring[(start + i) & RING_MASK], &samples[i]);
+        }
+    } while (g_writeCount - start > ACCEL_SAMPLER_BUFFER_SIZE);
+
+    *cursor = start + n;
+    return n;
+}
+
+unsigned long AccelSampler_GetSampleCount(void)
+{
+    return g_writeCount;
+}
+
+unsigned long AccelSampler_GetErrorCount(void)
+{
+    return g_errorCount;
+}
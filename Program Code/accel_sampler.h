@@ -0,0 +1,77 @@
+//*****************************************************************************
+// BMA222 Accelerometer Sampler
+// Reads all three axes in one auto-increment I2C burst (registers 0x02-0x07)
+// and, optionally, samples them from the TIMERA1 interrupt into a ring
+// buffer. The interrupt is the only writer; readers copy samples out without
+// disabling interrupts and retry if the writer lapped them, so a frame that
+// asks for the latest reading never waits on the I2C bus.
+//*****************************************************************************
+
+#ifndef ACCEL_SAMPLER_H_
+#define ACCEL_SAMPLER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Ring buffer size in samples, a power of two. Bounds the averaging window.
+#ifndef ACCEL_SAMPLER_BUFFER_SIZE
+#define ACCEL_SAMPLER_BUFFER_SIZE   32
+#endif
+
+// Supported sampling rates. One burst takes about 250us at 400kHz, so 1kHz
+// spends a quarter of the CPU in the interrupt.
+#define ACCEL_SAMPLER_MIN_RATE_HZ   10
+#define ACCEL_SAMPLER_MAX_RATE_HZ   1000
+
+// One reading, in the BMA222's 8-bit counts (about 64 per g at +/-2g)
+typedef struct {
+    int8_t x;
+    int8_t y;
+    int8_t z;
+} AccelSample;
+
+//*****************************************************************************
+// Blocking burst read of all three axes. Must not be called while the
+// sampler is running, since the interrupt owns the bus then. Returns 0, or
+// -1 on an I2C error.
+//*****************************************************************************
+int AccelSampler_ReadBurst(AccelSample *sample);
+
+//*****************************************************************************
+// Start sampling at rateHz (clamped to the supported range) on TIMERA1, or
+// change the rate if already running. The ring buffer starts out empty.
+// I2C must already be open.
+//*****************************************************************************
+void AccelSampler_Start(unsigned long rateHz);
+
+void AccelSampler_Stop(void);
+bool AccelSampler_IsRunning(void);
+
+//*****************************************************************************
+// Copy out the newest sample. Returns false until the first one arrives.
+//*****************************************************************************
+bool AccelSampler_GetLatest(AccelSample *sample);
+
+//*****************************************************************************
+// Average of the newest count samples (at most ACCEL_SAMPLER_BUFFER_SIZE),
+// rounded to the nearest count. Returns how many samples went into it, 0 if
+// none have arrived yet.
+//*****************************************************************************
+int AccelSampler_GetAverage(AccelSample *sample, int count);
+
+//*****************************************************************************
+// Stream access for consumers that filter every sample. Copies out up to max
+// samples taken after *cursor, oldest first, and advances *cursor past them.
+// Start with *cursor = 0. If the consumer fell more than a buffer behind (or
+// the sampler was restarted) it resumes from the oldest sample still held.
+// Returns the number of samples copied.
+//*****************************************************************************
+int AccelSampler_ReadNew(unsigned long *cursor, AccelSample *samples, int max);
+
+//*****************************************************************************
+// Samples taken and I2C errors since the sampler was started
+//*****************************************************************************
+unsigned long AccelSampler_GetSampleCount(void);
+unsigned long AccelSampler_GetErrorCount(void);
+
+#endif /* ACCEL_SAMPLER_H_ */
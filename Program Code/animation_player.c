@@ -0,0 +1,271 @@
+//*****************************************************************************
+// Animation Player
+// See animation_player.h for an overview and the file layout. Each frame is
+// one sl_FsRead of its record into a shared buffer, then one fastDrawBitmap()
+// window per rectangle.
+//*****************************************************************************
+
+// Standard includes
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "simplelink.h"
+
+#include "Adafruit_SSD1351.h"
+#include "display_dma.h"
+#include "asset_manager.h"
+#include "game_loop.h"
+#include "animation_player.h"
+
+#define SUCCESS                 0
+#define FAILURE                 -1
+
+// Size of the fallback frames
+#define FALLBACK_SIZE           128
+
+#define RECT_HEADER_SIZE        4
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t frameCount;
+    uint16_t width;
+    uint16_t height;
+    uint16_t fps;
+    uint16_t reserved;
+} AnimationHeader;
+
+//*****************************************************************************
+// Global Variables
+//*****************************************************************************
+static uint8_t g_record[ANIMATION_MAX_RECORD];  // shared, records are drawn synchronously
+
+//*****************************************************************************
+// Helpers
+//*****************************************************************************
+static uint32_t TicksPerFrame(uint16_t fps)
+{
+    if (fps == 0) {
+        fps = ANIMATION_DEFAULT_FPS;
+    }
+    return GAME_LOOP_TICKS_PER_SEC / fps;
+}
+
+static void UseFallback(AnimationPlayer *player)
+{
+    player->fileOpen = false;
+    player->frameCount = player->fallbackFrames;
+    player->width = FALLBACK_SIZE;
+    player->height = FALLBACK_SIZE;
+    player->frameTicks = TicksPerFrame(ANIMATION_DEFAULT_FPS);
+    if (player->frame >= player->frameCount) {
+        player->frame = 0;
+    }
+}
+
+static bool ReadTable(AnimationPlayer *player)
+{
+    AnimationHeader header;
+    long tableLength;
+    int i;
+
+    if (sl_FsRead(player->handle, 0, (unsigned char*)&header, sizeof(header)) != sizeof(header) ||
+        header.magic != ANIMATION_MAGIC || header.version != ANIMATION_VERSION ||
+        header.frameCount == 0 || header.frameCount > ANIMATION_MAX_FRAMES ||
+        header.width == 0 || header.width > SSD1351WIDTH ||
+        header.height == 0 || header.height > SSD1351HEIGHT) {
+        return false;
+    }
+
+    tableLength = (header.frameCount + 2) * sizeof(uint32_t);
+    if (sl_FsRead(player->handle, sizeof(header), (unsigned char*)player->records,
+                  tableLength) != tableLength) {
+        return false;
+    }
+
+    // Records follow the table in order, each holding at least its count
+    if (player->records[0] != sizeof(header) + tableLength) {
+        return false;
+    }
+    for (i = 0; i <= header.frameCount; i++) {
+        uint32_t length = player->records[i + 1] - player->records[i];
+
+        if (player->records[i + 1] <= player->records[i] || length < 2 ||
+            length > ANIMATION_MAX_RECORD) {
+            return false;
+        }
+    }
+
+    player->frameCount = header.frameCount;
+    player->width = header.width;
+    player->height = header.height;
+    player->frameTicks = TicksPerFrame(header.fps);
+    return true;
+}
+
+// Read record index and draw its rectangles. Returns false on a read error
+// or a rectangle outside the animation; the frame may be half drawn then.
+static bool DrawRecord(AnimationPlayer *player, int index)
+{
+    uint32_t offset = player->records[index];
+    long length = player->records[index + 1] - offset;
+    int byteWidth = (player->width + 7) / 8;
+    uint32_t pos = 2;
+    uint16_t rects;
+
+    if (sl_FsRead(player->handle, offset, g_record, length) != length) {
+        return false;
+    }
+    player->bytesRead += length;
+
+    rects = g_record[0] | (g_record[1] << 8);
+    while (rects-- > 0) {
+        const uint8_t *rect = &g_record[pos];
+        int rectX, rectY, rectWidth, rectHeight, pixelWidth;
+
+        if (pos + RECT_HEADER_SIZE > (uint32_t)length) {
+            return false;
+        }
+        rectX = rect[0];
+        rectY = rect[1];
+        rectWidth = rect[2];
+        rectHeight = rect[3];
+        pos += RECT_HEADER_SIZE + rectWidth * rectHeight;
+        if (rectWidth == 0 || rectHeight == 0 || pos > (uint32_t)length ||
+            rectX + rectWidth > byteWidth || rectY + rectHeight > player->height) {
+            return false;
+        }
+
+        // The last byte column may run past an odd animation width
+        pixelWidth = rectWidth * 8;
+        if (rectX * 8 + pixelWidth > player->width) {
+            pixelWidth = player->width - rectX * 8;
+        }
+        fastDrawBitmap(player->x + rectX * 8, player->y + rectY, rect + RECT_HEADER_SIZE,
+                       pixelWidth, rectHeight, player->color, player->bgColor, 1);
+    }
+    return true;
+}
+
+// Put player->frame on screen, from record index when the file is open
+static void ShowFrame(AnimationPlayer *player, int index)
+{
+    if (player->fileOpen && !DrawRecord(player, index)) {
+        // A damaged file: carry on with whole fallback frames
+        AnimationPlayer_Close(player);
+        UseFallback(player);
+    }
+    if (!player->fileOpen && player->frameCount > 0) {
+        if (player->fallbackAsset != ANIMATION_NO_ASSET) {
+            // The previous frame may still be on its way from the cache
+            Display_WaitIdle();
+            AssetManager_DrawFrame((AssetId)player->fallbackAsset, player->frame,
+                                   player->x, player->y, player->color, player->bgColor);
+        } else if (player->fallback != NULL) {
+            fastDrawBitmap(player->x, player->y, player->fallback(player->frame),
+                           FALLBACK_SIZE, FALLBACK_SIZE, player->color, player->bgColor, 1);
+        }
+    }
+    player->framesDrawn++;
+}
+
+// Reset the player with fallbackFrames fallback frames, then try the file
+static int OpenFile(AnimationPlayer *player, const char *fileName, uint16_t fallbackFrames)
+{
+    player->fallbackFrames = fallbackFrames;
+    player->frame = 0;
+    player->x = 0;
+    player->y = 0;
+    player->nextTicks = 0;
+    player->framesDrawn = 0;
+    player->lateFrames = 0;
+    player->bytesRead = 0;
+    UseFallback(player);
+
+    if (sl_FsOpen((unsigned char*)fileName, FS_MODE_OPEN_READ, NULL, &player->handle) < 0) {
+        return FAILURE;
+    }
+    player->fileOpen = true;
+
+    if (!ReadTable(player)) {
+        AnimationPlayer_Close(player);
+        UseFallback(player);
+        return FAILURE;
+    }
+    return SUCCESS;
+}
+
+//*****************************************************************************
+// Public API
+//*****************************************************************************
+int AnimationPlayer_Open(AnimationPlayer *player, const char *fileName,
+                         AssetId fallback)
+{
+    const AssetDescriptor *desc = AssetManager_GetDescriptor(fallback);
+
+    player->fallbackAsset = (desc != NULL) ? (int)fallback : ANIMATION_NO_ASSET;
+    player->fallback = NULL;
+    return OpenFile(player, fileName, (desc != NULL) ? desc->frameCount : 0);
+}
+
+int AnimationPlayer_OpenFrames(AnimationPlayer *player, const char *fileName,
+                               AnimationFrameFn fallback, uint16_t fallbackFrames)
+{
+    player->fallbackAsset = ANIMATION_NO_ASSET;
+    player->fallback = fallback;
+    return OpenFile(player, fileName, fallbackFrames);
+}
+
+void AnimationPlayer_Close(AnimationPlayer *player)
+{
+    if (player->fileOpen) {
+        sl_FsClose(player->handle, 0, 0, 0);
+        player->fileOpen = false;
+    }
+}
+
+void AnimationPlayer_Start(AnimationPlayer *player, int x, int y,
+                           uint16_t color, uint16_t bg_color)
+{
+    GameLoop_InitClock();
+
+    player->x = x;
+    player->y = y;
+    player->color = color;
+    player->bgColor = bg_color;
+    player->frame = 0;
+    ShowFrame(player, 0);
+    player->nextTicks = GameLoop_Ticks() + player->frameTicks;
+}
+
+bool AnimationPlayer_IsDue(const AnimationPlayer *player)
+{
+    return (int32_t)(GameLoop_Ticks() - player->nextTicks) >= 0;
+}
+
+bool AnimationPlayer_Update(AnimationPlayer *player)
+{
+    uint32_t now = GameLoop_Ticks();
+
+    if ((int32_t)(now - player->nextTicks) < 0) {
+        return false;
+    }
+
+    // The last record takes the last frame back to frame 0
+    player->frame = (player->frame + 1 < player->frameCount) ? player->frame + 1 : 0;
+    ShowFrame(player, (player->frame == 0) ? player->frameCount : player->frame);
+
+    // Keep the rate steady, but start over rather than rush to catch up
+    player->nextTicks += player->frameTicks;
+    if ((int32_t)(now - player->nextTicks) >= 0) {
+        player->nextTicks = now + player->frameTicks;
+        player->lateFrames++;
+    }
+    return true;
+}
+
+uint16_t AnimationPlayer_GetFrameCount(const AnimationPlayer *player)
+{
+    return player->frameCount;
+}
@@ -0,0 +1,118 @@
+//*****************************************************************************
+// Animation Player
+// Plays full-screen 1bpp animations stored as one keyframe plus per-frame
+// deltas, at a fixed frame rate. A delta lists the rectangles of 8-pixel
+// wide tiles that changed since the previous frame, so each frame redraws
+// only those through small display windows instead of the whole 128x128
+// screen. Frames are paced on the GameLoop clock: the player draws a frame
+// when it is due and returns straight away otherwise, so callers poll it
+// from their loops instead of padding with MAP_UtilsDelay().
+//
+// Animations are "/<name>.anim" files written from the GIFs by
+// Helper Programs/image_bitmap_generator.py. When the file is missing or
+// damaged the player falls back to drawing whole frames at the same rate:
+// asset frames through AssetManager_DrawFrame(), so PackBits frames in the
+// archive still stream straight to the display, and frames built into the
+// image from a get_X_frame() function.
+//
+// File layout, little-endian:
+//   header   magic "BMPA", uint16 version, uint16 frame count, uint16 width,
+//            uint16 height, uint16 frames per second, uint16 reserved
+//   table    frame count + 2 uint32 record offsets from the start of the file
+//   records  record 0 draws the keyframe (frame 0), record n frame n from
+//            frame n - 1, and the last record frame 0 from the last frame
+//            so the animation loops
+//
+// A record is a uint16 rectangle count, then per rectangle uint8 x (in
+// bytes), uint8 y, uint8 width (in bytes), uint8 height and width * height
+// bytes of bitmap rows.
+//*****************************************************************************
+
+#ifndef ANIMATION_PLAYER_H_
+#define ANIMATION_PLAYER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "asset_manager.h"
+
+#define ANIMATION_MAGIC         0x41504D42UL    // "BMPA"
+#define ANIMATION_VERSION       1
+
+// Longest animation the record table has room for
+#ifndef ANIMATION_MAX_FRAMES
+#define ANIMATION_MAX_FRAMES    64
+#endif
+
+// Largest record: one rectangle covering the whole screen
+#define ANIMATION_MAX_RECORD    (2 + 4 + 2048)
+
+// Rate of fallback frames, and of files that do not give one
+#define ANIMATION_DEFAULT_FPS   30
+
+// fallbackAsset of a player whose fallback is a frame function
+#define ANIMATION_NO_ASSET      (-1)
+
+typedef const uint8_t* (*AnimationFrameFn)(uint16_t frame);
+
+typedef struct {
+    bool fileOpen;                  // playing records rather than fallback frames
+    long handle;
+    int fallbackAsset;              // AssetId, or ANIMATION_NO_ASSET
+    AnimationFrameFn fallback;      // whole 128x128 frames, or NULL
+    uint16_t fallbackFrames;
+    uint16_t frameCount;
+    uint16_t width;
+    uint16_t height;
+    uint16_t frame;                 // frame on screen
+    int x;
+    int y;
+    uint16_t color;
+    uint16_t bgColor;
+    uint32_t frameTicks;            // GameLoop ticks per frame
+    uint32_t nextTicks;             // when the next frame is due
+    unsigned long framesDrawn;
+    unsigned long lateFrames;       // frames drawn a whole period or more late
+    unsigned long bytesRead;
+    uint32_t records[ANIMATION_MAX_FRAMES + 2];
+} AnimationPlayer;
+
+//*****************************************************************************
+// Open an animation file, e.g. "/loading_screen.anim", and read its record
+// table. Returns 0, or -1 when the file is missing or invalid; the player
+// then draws the frames of fallback with AssetManager_DrawFrame() at
+// ANIMATION_DEFAULT_FPS.
+//*****************************************************************************
+int AnimationPlayer_Open(AnimationPlayer *player, const char *fileName,
+                         AssetId fallback);
+
+//*****************************************************************************
+// Same for an animation whose frames are built into the image: the fallback
+// draws fallbackFrames frames from fallback (if not NULL) instead.
+//*****************************************************************************
+int AnimationPlayer_OpenFrames(AnimationPlayer *player, const char *fileName,
+                               AnimationFrameFn fallback, uint16_t fallbackFrames);
+
+void AnimationPlayer_Close(AnimationPlayer *player);
+
+//*****************************************************************************
+// Draw frame 0 in full at (x, y) and start the frame clock. Call again to
+// restart after something else has drawn over the animation.
+//*****************************************************************************
+void AnimationPlayer_Start(AnimationPlayer *player, int x, int y,
+                           uint16_t color, uint16_t bg_color);
+
+//*****************************************************************************
+// True once the frame on screen has been shown for a whole frame period
+//*****************************************************************************
+bool AnimationPlayer_IsDue(const AnimationPlayer *player);
+
+//*****************************************************************************
+// When the next frame is due, draw it (wrapping to frame 0 after the last)
+// and return true; otherwise return false without drawing
+//*****************************************************************************
+bool AnimationPlayer_Update(AnimationPlayer *player);
+
+uint16_t AnimationPlayer_GetFrameCount(const AnimationPlayer *player);
+
+#endif /* ANIMATION_PLAYER_H_ */
@@ -0,0 +1,737 @@
+//*****************************************************************************
+// Asset Manager
+// See asset_manager.h for an overview. Cached frames live in one arena;
+// the entry table is kept in arena order so free gaps can be found by
+// walking it. Frames are rounded up to whole words. A frame of a PackBits
+// asset can be cached in both forms: coded for drawing, decoded for
+// AssetManager_Get(). The archive table is indexed by asset id; frameCount
+// 0 marks an id the archive does not have. Embedded assets never touch the
+// cache, their frames are returned in place from the atlas.
+//*****************************************************************************
+
+// Standard includes
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "simplelink.h"
+
+#include "Adafruit_SSD1351.h"
+#include "framebuffer.h"
+#include "display_dma.h"
+#include "packbits.h"
+#include "sprite_atlas.h"
+#include "asset_manager.h"
+
+#if ASSET_MANAGER_BENCHMARK
+#include "systick.h"
+#include "uart_if.h"
+#include "oled_test.h"
+#endif
+
+#if ASSET_CACHE_BYTES < 3 * ASSET_MAX_FRAME_SIZE
+#error "ASSET_CACHE_BYTES must hold at least three of the largest frames"
+#endif
+#if ASSET_CACHE_BYTES > 65532
+#error "ASSET_CACHE_BYTES must fit the 16-bit entry offsets"
+#endif
+
+#define SUCCESS                 0
+#define FAILURE                 -1
+
+#define ALIGN_SIZE(n)           (((n) + 3) & ~3)
+
+// Archive checksum state per asset
+#define CHECK_PENDING           0
+#define CHECK_GOOD              1
+#define CHECK_BAD               2
+
+// Form a frame is cached in
+#define FORM_BITMAP             0
+#define FORM_PACKBITS           1
+
+// Checksum reads go through a stack buffer of this size
+#define CHECK_CHUNK             256
+
+typedef struct {
+    uint8_t asset;
+    uint8_t pins;
+    uint8_t form;
+    uint16_t frame;
+    uint16_t offset;                // into g_arena, in bytes
+    uint16_t size;                  // rounded up to whole words
+    uint16_t length;                // bytes of frame data
+    uint32_t lastUse;
+} CacheEntry;
+
+typedef struct {
+    AssetDescriptor desc;
+    uint16_t encoding;
+    uint32_t offset;
+    uint32_t length;
+    uint32_t checksum;
+    uint8_t check;
+} ArchiveAsset;
+
+//*****************************************************************************
+// Asset table. Sizes match the defines in the bitmap helper headers. The
+// character sprites are drawn every game frame and come from the atlas.
+//*****************************************************************************
+static const AssetDescriptor g_assets[ASSET_COUNT] = {
+    [ASSET_MAP]                     = {"map",                   128, 128, 6, 2048, ASSET_STORAGE_FS},
+    [ASSET_CHARACTER_RUN_LEFT]      = {"character_run_left",     13,  17, 4,   34, ASSET_STORAGE_EMBEDDED},
+    [ASSET_CHARACTER_RUN_RIGHT]     = {"character_run_right",    13,  17, 4,   34, ASSET_STORAGE_EMBEDDED},
+    [ASSET_CHARACTER_JUMP]          = {"character_jump",         13,  17, 6,   34, ASSET_STORAGE_EMBEDDED},
+    [ASSET_CHARACTER_DOUBLE_JUMP]   = {"character_double_jump",  13,  17, 6,   34, ASSET_STORAGE_EMBEDDED},
+    [ASSET_CURSOR]                  = {"cursor",                 20,  30, 3,   90, ASSET_STORAGE_FS},
+    [ASSET_OPTION_BACKGROUND]       = {"optionBackground",      128, 128, 8, 2048, ASSET_STORAGE_FS},
+    [ASSET_LOADING_SCREEN]          = {"loading_screen",        128, 128, 6, 2048, ASSET_STORAGE_FS},
+    [ASSET_WIFILOADING]             = {"wifiloading",           128, 128, 4, 2048, ASSET_STORAGE_FS},
+    [ASSET_CONNECTED]               = {"connected",             128, 128, 8, 2048, ASSET_STORAGE_FS},
+    [ASSET_FUNCGENERATOR]           = {"funcgenerator",         128, 128, 8, 2048, ASSET_STORAGE_FS},
+    [ASSET_OSCILLOSCOPE]            = {"oscilloscope",          128, 128, 8, 2048, ASSET_STORAGE_FS},
+    [ASSET_COMPONENTPURPOSE]        = {"componentpurpose",      128, 128, 3, 2048, ASSET_STORAGE_FS},
+    [ASSET_PINPURPOSE]              = {"pinpurpose",            128, 128, 3, 2048, ASSET_STORAGE_FS},
+    [ASSET_SERVOARM]                = {"servoarm",              128, 128, 2, 2048, ASSET_STORAGE_FS},
+    [ASSET_ELECTRONICHELPER]        = {"electronichelper",      128, 128, 2, 2048, ASSET_STORAGE_FS},
+};
+
+//*****************************************************************************
+// Global Variables
+//*****************************************************************************
+static uint32_t g_arena[ASSET_CACHE_BYTES / 4];
+static CacheEntry g_entries[ASSET_CACHE_ENTRIES];  // in arena order
+static int g_entryCount = 0;
+static uint32_t g_useClock = 0;
+static AssetStats g_stats;
+
+static ArchiveAsset g_archive[ASSET_MAX_IDS];
+static bool g_archiveLoaded = false;        // g_archive holds a valid table
+static bool g_archiveHandleOpen = false;
+static long g_archiveHandle;
+
+// CRC-32 (the zlib polynomial), four bits at a time
+static const uint32_t g_crcNibble[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+    0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+    0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+//*****************************************************************************
+// Helpers
+//*****************************************************************************
+static uint8_t* EntryData(const CacheEntry *entry)
+{
+    return (uint8_t*)g_arena + entry->offset;
+}
+
+static int FindEntry(AssetId asset, uint16_t frame, uint8_t form)
+{
+    int i;
+
+    for (i = 0; i < g_entryCount; i++) {
+        if (g_entries[i].asset == asset && g_entries[i].frame == frame &&
+            g_entries[i].form == form) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void RemoveEntry(int index)
+{
+    g_stats.bytesUsed -= g_entries[index].size;
+    memmove(&g_entries[index], &g_entries[index + 1],
+            (g_entryCount - index - 1) * sizeof(CacheEntry));
+    g_entryCount--;
+}
+
+// Evict the least recently used frame that is not pinned
+static bool EvictOne(void)
+{
+    int victim = -1;
+    int i;
+
+    for (i = 0; i < g_entryCount; i++) {
+        if (g_entries[i].pins == 0 &&
+            (victim < 0 || g_entries[i].lastUse < g_entries[victim].lastUse)) {
+            victim = i;
+        }
+    }
+    if (victim < 0) {
+        return false;
+    }
+
+    RemoveEntry(victim);
+    g_stats.evictions++;
+    return true;
+}
+
+// First gap of at least size bytes. Returns the table index the new entry
+// goes at and its offset, or -1 when no gap is big enough.
+static int FindGap(uint16_t size, uint16_t *offset)
+{
+    uint32_t start = 0;
+    int i;
+
+    for (i = 0; i < g_entryCount; i++) {
+        if (g_entries[i].offset - start >= size) {
+            *offset = (uint16_t)start;
+            return i;
+        }
+        start = g_entries[i].offset + g_entries[i].size;
+    }
+    if (ASSET_CACHE_BYTES - start >= size) {
+        *offset = (uint16_t)start;
+        return g_entryCount;
+    }
+    return -1;
+}
+
+static uint32_t Crc32Update(uint32_t crc, const uint8_t *data, uint32_t length)
+{
+    while (length--) {
+        crc ^= *data++;
+        crc = (crc >> 4) ^ g_crcNibble[crc & 15];
+        crc = (crc >> 4) ^ g_crcNibble[crc & 15];
+    }
+    return crc;
+}
+
+// Archive entry of an asset that has not failed its checksum, or NULL
+static ArchiveAsset* ArchiveLookup(AssetId asset)
+{
+    ArchiveAsset *packed;
+
+    if (!g_archiveLoaded || (unsigned)asset >= ASSET_MAX_IDS) {
+        return NULL;
+    }
+    packed = &g_archive[asset];
+    if (packed->desc.frameCount == 0 || packed->check == CHECK_BAD) {
+        return NULL;
+    }
+    return packed;
+}
+
+// Atlas entry of an embedded asset, or NULL to read it from the file system.
+// An atlas built from other art than g_assets describes is not used.
+static const SpriteAtlasAsset* AtlasLookup(AssetId asset)
+{
+    const AssetDescriptor *desc;
+    int i;
+
+    if ((unsigned)asset >= ASSET_COUNT || g_assets[asset].storage != ASSET_STORAGE_EMBEDDED) {
+        return NULL;
+    }
+    desc = &g_assets[asset];
+    for (i = 0; i < SPRITE_ATLAS_ASSET_COUNT; i++) {
+        const SpriteAtlasAsset *sprite = &g_spriteAtlasAssets[i];
+
+        if (sprite->assetId == asset) {
+            if (sprite->width != desc->width || sprite->height != desc->height ||
+                sprite->frameCount != desc->frameCount || sprite->frameSize != desc->frameSize) {
+                return NULL;
+            }
+            return sprite;
+        }
+    }
+    return NULL;
+}
+
+// Frame of an embedded asset, in place in the atlas, or NULL
+static const uint8_t* AtlasFrame(AssetId asset, uint16_t frame)
+{
+    const SpriteAtlasAsset *sprite = AtlasLookup(asset);
+
+    if (sprite == NULL) {
+        return NULL;
+    }
+    if (frame >= sprite->frameCount) {
+        frame = 0;
+    }
+    g_stats.embeddedHits++;
+    return &g_spriteAtlas[g_spriteAtlasOffsets[sprite->firstFrame + frame]];
+}
+
+static bool ReadArchive(uint32_t offset, uint8_t *dest, uint16_t length)
+{
+    int attempt;
+
+    for (attempt = 0; attempt < 2; attempt++) {
+        if (!g_archiveHandleOpen) {
+            if (sl_FsOpen((unsigned char*)ASSET_ARCHIVE_FILE, FS_MODE_OPEN_READ,
+                          NULL, &g_archiveHandle) < 0) {
+                return false;
+            }
+            g_archiveHandleOpen = true;
+        }
+        if (sl_FsRead(g_archiveHandle, offset, dest, length) == (long)length) {
+            return true;
+        }
+
+        // The handle goes stale when SimpleLink restarts: reopen it once
+        sl_FsClose(g_archiveHandle, 0, 0, 0);
+        g_archiveHandleOpen = false;
+    }
+    return false;
+}
+
+// Checksum the asset's data. A read error fails the check as well.
+static void CheckArchiveAsset(ArchiveAsset *packed)
+{
+    uint8_t chunk[CHECK_CHUNK];
+    uint32_t crc = 0xFFFFFFFF;
+    uint32_t done = 0;
+
+    while (done < packed->length) {
+        uint16_t n = (packed->length - done > CHECK_CHUNK) ? CHECK_CHUNK : packed->length - done;
+
+        if (!ReadArchive(packed->offset + done, chunk, n)) {
+            break;
+        }
+        crc = Crc32Update(crc, chunk, n);
+        done += n;
+    }
+
+    if (done == packed->length && ~crc == packed->checksum) {
+        packed->check = CHECK_GOOD;
+    } else {
+        packed->check = CHECK_BAD;
+        g_stats.checksumErrors++;
+    }
+}
+
+// Read a frame from its own file, or fill in the default pattern when the
+// file is missing
+static void LoadFrameFile(AssetId asset, uint16_t frame, uint8_t *dest, uint16_t frameSize)
+{
+    char filename[64];
+    long fileHandle;
+    long bytesRead = -1;
+
+    if ((unsigned)asset < ASSET_COUNT) {
+        sprintf(filename, "/%sFrames_%d.bin", g_assets[asset].name, frame);
+
+        if (sl_FsOpen((unsigned char*)filename, FS_MODE_OPEN_READ, NULL, &fileHandle) >= 0) {
+            bytesRead = sl_FsRead(fileHandle, 0, dest, frameSize);
+            sl_FsClose(fileHandle, 0, 0, 0);
+        }
+    }
+
+    if (bytesRead < 0) {
+        memset(dest, 0, frameSize);
+        dest[3] = 0x08;     // Default dot
+        g_stats.loadErrors++;
+    } else if (bytesRead < frameSize) {
+        memset(dest + bytesRead, 0, frameSize - bytesRead);
+    }
+}
+
+// Insert an entry for length bytes, evicting as needed. Returns its index,
+// or -1 when pinned frames leave no room.
+static int AddEntry(AssetId asset, uint16_t frame, uint8_t form, uint16_t length)
+{
+    uint16_t size = ALIGN_SIZE(length);
+    uint16_t offset;
+    int index;
+
+    while (g_entryCount >= ASSET_CACHE_ENTRIES ||
+           (index = FindGap(size, &offset)) < 0) {
+        if (!EvictOne()) {
+            return -1;
+        }
+    }
+
+    memmove(&g_entries[index + 1], &g_entries[index],
+            (g_entryCount - index) * sizeof(CacheEntry));
+    g_entryCount++;
+    g_entries[index].asset = (uint8_t)asset;
+    g_entries[index].pins = 0;
+    g_entries[index].form = form;
+    g_entries[index].frame = frame;
+    g_entries[index].offset = offset;
+    g_entries[index].size = size;
+    g_entries[index].length = length;
+    g_entries[index].lastUse = ++g_useClock;
+    g_stats.bytesUsed += size;
+    return index;
+}
+
+// Coded frame of a PackBits asset. The asset's data starts with the
+// frame offsets, frameCount + 1 of them, relative to the asset.
+static int LoadCodedFrame(const ArchiveAsset *packed, AssetId asset, uint16_t frame)
+{
+    uint32_t bounds[2];
+    uint32_t length;
+    int index;
+
+    if (packed == NULL || packed->encoding != ASSET_ENCODING_PACKBITS ||
+        !ReadArchive(packed->offset + frame * sizeof(uint32_t), (uint8_t*)bounds, sizeof(bounds))) {
+        return -1;
+    }
+    length = bounds[1] - bounds[0];
+    if (bounds[1] <= bounds[0] || bounds[1] > packed->length || length > packed->desc.frameSize) {
+        return -1;
+    }
+
+    index = AddEntry(asset, frame, FORM_PACKBITS, (uint16_t)length);
+    if (index < 0) {
+        return -1;
+    }
+    if (!ReadArchive(packed->offset + bounds[0], EntryData(&g_entries[index]), (uint16_t)length)) {
+        RemoveEntry(index);
+        return -1;
+    }
+    return index;
+}
+
+static int FetchFrame(AssetId asset, uint16_t frame, uint8_t form);
+
+// Decoded frame of a PackBits asset, from its coded form (which is kept
+// pinned while the decoded frame is placed)
+static int DecodeFrame(const ArchiveAsset *packed, AssetId asset, uint16_t frame)
+{
+    uint16_t frameSize = packed->desc.frameSize;
+    int coded, index;
+
+    coded = FetchFrame(asset, frame, FORM_PACKBITS);
+    if (coded < 0) {
+        return -1;
+    }
+
+    g_entries[coded].pins++;
+    index = AddEntry(asset, frame, FORM_BITMAP, frameSize);
+    coded = FindEntry(asset, frame, FORM_PACKBITS);
+    g_entries[coded].pins--;
+    if (index < 0) {
+        return -1;
+    }
+
+    if (PackBits_Decode(EntryData(&g_entries[coded]), g_entries[coded].length,
+                        EntryData(&g_entries[index]), frameSize) != frameSize) {
+        memset(EntryData(&g_entries[index]), 0, frameSize);
+        EntryData(&g_entries[index])[3] = 0x08;     // Default dot
+        g_stats.loadErrors++;
+    }
+    return index;
+}
+
+// Cache index of a frame, loading it on a miss, or -1
+// Display_DrawBitmapAsync() done callback: the transfer has stopped reading
+// the frame, so it may be evicted again
+static void ReleaseDrawnFrame(void *frame)
+{
+    AssetManager_Release((const uint8_t*)frame);
+}
+
+static int FetchFrame(AssetId asset, uint16_t frame, uint8_t form)
+{
+    const AssetDescriptor *desc;
+    ArchiveAsset *packed;
+    int index;
+
+    // First use of an archive asset: check it, fall back to files if bad
+    packed = ArchiveLookup(asset);
+    if (packed != NULL && packed->check == CHECK_PENDING) {
+        CheckArchiveAsset(packed);
+        packed = ArchiveLookup(asset);
+    }
+
+    desc = AssetManager_GetDescriptor(asset);
+    if (desc == NULL) {
+        return -1;
+    }
+    if (frame >= desc->frameCount) {
+        frame = 0;
+    }
+
+    index = FindEntry(asset, frame, form);
+    if (index >= 0) {
+        g_stats.hits++;
+        g_entries[index].lastUse = ++g_useClock;
+        return index;
+    }
+    g_stats.misses++;
+
+    if (form == FORM_PACKBITS) {
+        return LoadCodedFrame(packed, asset, frame);
+    }
+
+    if (packed != NULL && packed->encoding == ASSET_ENCODING_PACKBITS) {
+        index = DecodeFrame(packed, asset, frame);
+        if (index >= 0) {
+            return index;
+        }
+        packed = NULL;      // file fallback below
+    }
+
+    index = AddEntry(asset, frame, FORM_BITMAP, desc->frameSize);
+    if (index < 0) {
+        return -1;
+    }
+    if (packed == NULL ||
+        !ReadArchive(packed->offset + (uint32_t)frame * desc->frameSize,
+                     EntryData(&g_entries[index]), desc->frameSize)) {
+        LoadFrameFile(asset, frame, EntryData(&g_entries[index]), desc->frameSize);
+    }
+    return index;
+}
+
+//*****************************************************************************
+// Public API
+//*****************************************************************************
+int AssetManager_OpenArchive(void)
+{
+    AssetArchiveHeader header;
+    AssetArchiveEntry entry;
+    uint32_t tableOffset = sizeof(header);
+    int i;
+
+    g_archiveLoaded = false;
+    memset(g_archive, 0, sizeof(g_archive));
+
+    if (!ReadArchive(0, (uint8_t*)&header, sizeof(header)) ||
+        header.magic != ASSET_ARCHIVE_MAGIC || header.version != ASSET_ARCHIVE_VERSION) {
+        AssetManager_CloseArchive();
+        return FAILURE;
+    }
+
+    for (i = 0; i < header.assetCount; i++) {
+        ArchiveAsset *packed;
+
+        if (!ReadArchive(tableOffset, (uint8_t*)&entry, sizeof(entry))) {
+            memset(g_archive, 0, sizeof(g_archive));
+            AssetManager_CloseArchive();
+            return FAILURE;
+        }
+        tableOffset += sizeof(entry);
+
+        // Skip entries this build has no room for or cannot read
+        if (entry.assetId >= ASSET_MAX_IDS || entry.frameCount == 0 ||
+            entry.frameSize == 0 || entry.frameSize > ASSET_MAX_FRAME_SIZE) {
+            continue;
+        }
+        if (entry.encoding == ASSET_ENCODING_RAW ?
+                (entry.length != (uint32_t)entry.frameCount * entry.frameSize) :
+                (entry.encoding != ASSET_ENCODING_PACKBITS ||
+                 entry.length < (entry.frameCount + 1) * sizeof(uint32_t))) {
+            continue;
+        }
+
+        packed = &g_archive[entry.assetId];
+        packed->desc.name = (entry.assetId < ASSET_COUNT) ? g_assets[entry.assetId].name : NULL;
+        packed->desc.width = entry.width;
+        packed->desc.height = entry.height;
+        packed->desc.frameCount = entry.frameCount;
+        packed->desc.frameSize = entry.frameSize;
+        packed->desc.storage = ASSET_STORAGE_FS;
+        packed->encoding = entry.encoding;
+        packed->offset = entry.offset;
+        packed->length = entry.length;
+        packed->checksum = entry.checksum;
+        packed->check = CHECK_PENDING;
+    }
+
+    g_archiveLoaded = true;
+    return SUCCESS;
+}
+
+void AssetManager_CloseArchive(void)
+{
+    if (g_archiveHandleOpen) {
+        sl_FsClose(g_archiveHandle, 0, 0, 0);
+        g_archiveHandleOpen = false;
+    }
+}
+
+const AssetDescriptor* AssetManager_GetDescriptor(AssetId asset)
+{
+    ArchiveAsset *packed;
+
+    if (AtlasLookup(asset) != NULL) {
+        return &g_assets[asset];
+    }
+    packed = ArchiveLookup(asset);
+    if (packed != NULL) {
+        return &packed->desc;
+    }
+    if ((unsigned)asset >= ASSET_COUNT) {
+        return NULL;
+    }
+    return &g_assets[asset];
+}
+
+const uint8_t* AssetManager_Get(AssetId asset, uint16_t frame)
+{
+    const uint8_t *embedded = AtlasFrame(asset, frame);
+    int index;
+
+    if (embedded != NULL) {
+        return embedded;
+    }
+    index = FetchFrame(asset, frame, FORM_BITMAP);
+    return (index < 0) ? NULL : EntryData(&g_entries[index]);
+}
+
+const uint8_t* AssetManager_Acquire(AssetId asset, uint16_t frame)
+{
+    const uint8_t *embedded = AtlasFrame(asset, frame);
+    int index;
+
+    // Atlas frames never move, there is nothing to pin
+    if (embedded != NULL) {
+        return embedded;
+    }
+    index = FetchFrame(asset, frame, FORM_BITMAP);
+    if (index < 0) {
+        return NULL;
+    }
+    if (g_entries[index].pins == 0) {
+        g_stats.pinned++;
+    }
+    g_entries[index].pins++;
+    return EntryData(&g_entries[index]);
+}
+
+void AssetManager_DrawFrame(AssetId asset, uint16_t frame, int x, int y,
+                            uint16_t color, uint16_t bg_color)
+{
+    const AssetDescriptor *desc = AssetManager_GetDescriptor(asset);
+    ArchiveAsset *packed = (AtlasLookup(asset) == NULL) ? ArchiveLookup(asset) : NULL;
+    const uint8_t *bitmap;
+    int index;
+
+    if (desc == NULL) {
+        return;
+    }
+
+    // Coded frames stream into an opaque on-screen window. The shadow
+    // framebuffer and transparent draws use the cached decoded bitmap, which
+    // redraws faster than decoding the rows again.
+    if (packed != NULL && packed->encoding == ASSET_ENCODING_PACKBITS &&
+        !Framebuffer_IsEnabled() && bg_color != 1 && x >= 0 && y >= 0 &&
+        x + desc->width <= SSD1351WIDTH && y + desc->height <= SSD1351HEIGHT) {
+        index = FetchFrame(asset, frame, FORM_PACKBITS);
+        if (index >= 0) {
+            fastDrawBitmapPackBits(x, y, EntryData(&g_entries[index]), g_entries[index].length,
+                                   desc->width, desc->height, color, bg_color);
+            return;
+        }
+    }
+
+    // The transfer reads the frame line by line after this returns; keep it
+    // pinned until it is done so later misses cannot evict or overwrite it
+    bitmap = AssetManager_Acquire(asset, frame);
+    if (bitmap != NULL) {
+        Display_DrawBitmapAsync(x, y, bitmap, desc->width, desc->height,
+                                color, bg_color, 1, ReleaseDrawnFrame, (void*)bitmap);
+    }
+}
+
+void AssetManager_Release(const uint8_t *frame)
+{
+    int i;
+
+    for (i = 0; i < g_entryCount; i++) {
+        if (EntryData(&g_entries[i]) == frame) {
+            if (g_entries[i].pins > 0 && --g_entries[i].pins == 0) {
+                g_stats.pinned--;
+            }
+            return;
+        }
+    }
+}
+
+void AssetManager_Flush(void)
+{
+    int i = 0;
+
+    while (i < g_entryCount) {
+        if (g_entries[i].pins == 0) {
+            RemoveEntry(i);
+        } else {
+            i++;
+        }
+    }
+}
+
+void AssetManager_GetStats(AssetStats *stats)
+{
+    *stats = g_stats;
+    stats->entries = g_entryCount;
+}
+
+void AssetManager_ResetStats(void)
+{
+    g_stats.hits = 0;
+    g_stats.misses = 0;
+    g_stats.embeddedHits = 0;
+    g_stats.evictions = 0;
+    g_stats.loadErrors = 0;
+    g_stats.checksumErrors = 0;
+}
+
+#if ASSET_MANAGER_BENCHMARK
+//*****************************************************************************
+// Benchmark
+// Frames are fetched in both forms before timing, so only the drawing is
+// measured. SysTick counts down at 80MHz; one full-screen draw fits its
+// range.
+//*****************************************************************************
+void AssetManager_Benchmark(void)
+{
+    unsigned long start, rawTicks, codedTicks;
+    int asset, frame;
+
+    SysTickDisable();
+    SysTickIntDisable();
+    SysTickPeriodSet(0xFFFFFF);
+    SysTickEnable();
+
+    Report("%-22s %6s %6s %9s %9s\n\r", "asset", "raw", "coded", "raw cyc", "coded cyc");
+
+    for (asset = 0; asset < ASSET_MAX_IDS; asset++) {
+        const ArchiveAsset *packed = ArchiveLookup((AssetId)asset);
+        unsigned long rawBytes = 0, codedBytes = 0;
+
+        if (packed == NULL || packed->encoding != ASSET_ENCODING_PACKBITS) {
+            continue;
+        }
+
+        rawTicks = 0;
+        codedTicks = 0;
+        for (frame = 0; frame < packed->desc.frameCount; frame++) {
+            const uint8_t *bitmap = AssetManager_Acquire((AssetId)asset, frame);
+            int coded = FetchFrame((AssetId)asset, frame, FORM_PACKBITS);
+
+            if (bitmap == NULL || coded < 0) {
+                AssetManager_Release(bitmap);
+                continue;
+            }
+
+            start = SysTickValueGet();
+            fastDrawBitmap(0, 0, bitmap, packed->desc.width, packed->desc.height, WHITE, BLACK, 1);
+            rawTicks += (start - SysTickValueGet()) & 0xFFFFFF;
+
+            start = SysTickValueGet();
+            fastDrawBitmapPackBits(0, 0, EntryData(&g_entries[coded]), g_entries[coded].length,
+                                   packed->desc.width, packed->desc.height, WHITE, BLACK);
+            codedTicks += (start - SysTickValueGet()) & 0xFFFFFF;
+
+            rawBytes += packed->desc.frameSize;
+            codedBytes += g_entries[coded].length;
+            AssetManager_Release(bitmap);
+        }
+
+        if (rawBytes > 0) {
+            int frames = rawBytes / packed->desc.frameSize;
+
+            Report("%-22s %6lu %6lu %9lu %9lu\n\r",
+                   packed->desc.name ? packed->desc.name : "(archive only)",
+                   rawBytes, codedBytes, rawTicks / frames, codedTicks / frames);
+        }
+    }
+}
+#endif // ASSET_MANAGER_BENCHMARK
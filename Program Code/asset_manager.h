@@ -0,0 +1,208 @@
+//*****************************************************************************
+// Asset Manager
+// Frames of the 1bpp bitmap assets uploaded to serial flash. Each asset has a
+// descriptor (file name, size, frame count) and its frames are read on
+// demand into a byte-budgeted RAM cache keyed by (asset, frame). When a new
+// frame does not fit, the least recently used frames that are not pinned are
+// evicted until it does, so a frame drawn every render costs one file read
+// instead of an sl_FsOpen/sl_FsRead/sl_FsClose per call.
+//
+// A frame from AssetManager_Get() stays at the same address until a later
+// miss evicts it. The cache holds at least three of the largest frames, so
+// the last frame returned always survives the next miss (unless pinned
+// frames take up the room) and can still be on the bus while the next one
+// loads. AssetManager_Acquire() pins a frame until AssetManager_Release().
+//
+// Frames come from one packed archive when it has been uploaded, otherwise
+// from the per-frame "/<name>Frames_<n>.bin" files. The archive stays open on
+// a single handle and each miss is one sl_FsRead at the frame's offset. Its
+// table also supplies the descriptors, so an asset can be added by
+// rebuilding the archive with Helper Programs/bitmap_converter.py.
+//
+// Archive layout, little-endian:
+//   header   magic "BMPK", uint16 version, uint16 asset count
+//   table    one AssetArchiveEntry per asset
+//   data     per asset at the entry's offset: raw frames back to back, or
+//            for PackBits assets (see packbits.h) frameCount + 1 uint32
+//            frame offsets relative to the asset, then the coded frames
+//
+// AssetManager_DrawFrame() streams PackBits frames into the display window
+// without decoding them; AssetManager_Get() decodes them into the cache.
+//
+// Each descriptor also carries a storage policy. ASSET_STORAGE_EMBEDDED
+// assets (the small, hot sprites) are served straight out of the const
+// atlas in sprite_atlas.c, generated by bitmap_converter.py --atlas: no
+// file read, no cache slot and no copy. The CC3200 loads the application
+// image into SRAM, so the atlas costs its size in image space; large assets
+// stay ASSET_STORAGE_FS. An embedded asset the atlas does not hold, or holds
+// at another size, is read from the file system as before.
+//
+// The get_X_frame() functions in "bitmap helper functions" are thin
+// wrappers around AssetManager_Get().
+//*****************************************************************************
+
+#ifndef ASSET_MANAGER_H_
+#define ASSET_MANAGER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// RAM set aside for cached frames: the menu's eight background frames plus
+// the cursor and sprite frames
+#ifndef ASSET_CACHE_BYTES
+#define ASSET_CACHE_BYTES       18432
+#endif
+
+// Most frames cached at once
+#ifndef ASSET_CACHE_ENTRIES
+#define ASSET_CACHE_ENTRIES     64
+#endif
+
+// Largest frame of any asset (a full 128x128 screen)
+#define ASSET_MAX_FRAME_SIZE    2048
+
+// Asset ids run below this; ids from ASSET_COUNT up are only in the archive
+#define ASSET_MAX_IDS           32
+
+#define ASSET_ARCHIVE_FILE      "/assets.bin"
+#define ASSET_ARCHIVE_MAGIC     0x4B504D42UL    // "BMPK"
+#define ASSET_ARCHIVE_VERSION   2
+
+#define ASSET_ENCODING_RAW      0
+#define ASSET_ENCODING_PACKBITS 1
+
+#define ASSET_STORAGE_FS        0       // archive or per-frame files
+#define ASSET_STORAGE_EMBEDDED  1       // sprite atlas in the image
+
+// Set to 1 to build AssetManager_Benchmark()
+#ifndef ASSET_MANAGER_BENCHMARK
+#define ASSET_MANAGER_BENCHMARK 0
+#endif
+
+typedef enum {
+    ASSET_MAP,
+    ASSET_CHARACTER_RUN_LEFT,
+    ASSET_CHARACTER_RUN_RIGHT,
+    ASSET_CHARACTER_JUMP,
+    ASSET_CHARACTER_DOUBLE_JUMP,
+    ASSET_CURSOR,
+    ASSET_OPTION_BACKGROUND,
+    ASSET_LOADING_SCREEN,
+    ASSET_WIFILOADING,
+    ASSET_CONNECTED,
+    ASSET_FUNCGENERATOR,
+    ASSET_OSCILLOSCOPE,
+    ASSET_COMPONENTPURPOSE,
+    ASSET_PINPURPOSE,
+    ASSET_SERVOARM,
+    ASSET_ELECTRONICHELPER,
+    ASSET_COUNT
+} AssetId;
+
+typedef struct {
+    const char *name;               // files are "/<name>Frames_<n>.bin", NULL
+                                    // for assets only in the archive
+    uint16_t width;
+    uint16_t height;
+    uint16_t frameCount;
+    uint16_t frameSize;             // bytes per frame
+    uint8_t storage;                // ASSET_STORAGE_*
+} AssetDescriptor;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t assetCount;
+} AssetArchiveHeader;
+
+typedef struct {
+    uint16_t assetId;
+    uint16_t width;
+    uint16_t height;
+    uint16_t frameCount;
+    uint16_t frameSize;             // decoded bytes per frame
+    uint16_t encoding;              // ASSET_ENCODING_*
+    uint32_t offset;                // of the asset's data, from the start of the file
+    uint32_t length;                // bytes of data
+    uint32_t checksum;              // CRC-32 of the data
+} AssetArchiveEntry;
+
+typedef struct {
+    unsigned long hits;
+    unsigned long misses;
+    unsigned long embeddedHits;     // frames served from the sprite atlas
+    unsigned long evictions;
+    unsigned long loadErrors;       // frames replaced by the default pattern
+    unsigned long checksumErrors;   // archive assets that failed their CRC
+    unsigned long bytesUsed;
+    int entries;
+    int pinned;
+} AssetStats;
+
+//*****************************************************************************
+// Open ASSET_ARCHIVE_FILE and read its table. Call once SimpleLink has
+// started. Returns 0, or -1 when there is no valid archive (frames keep
+// coming from the per-frame files). Each asset's checksum is
+// checked the first time one of its frames is read; an asset that fails
+// falls back to its per-frame files.
+//*****************************************************************************
+int AssetManager_OpenArchive(void);
+
+//*****************************************************************************
+// Close the archive handle, e.g. before sl_Stop(). Cached frames and the
+// archive table stay; the next miss opens the handle again.
+//*****************************************************************************
+void AssetManager_CloseArchive(void);
+
+//*****************************************************************************
+// Descriptor of an asset, from the archive when it has the asset, or NULL
+// for an unknown id
+//*****************************************************************************
+const AssetDescriptor* AssetManager_GetDescriptor(AssetId asset);
+
+//*****************************************************************************
+// A frame of an asset, read from flash on a miss. Frame indexes past the end
+// fall back to frame 0. A file that cannot be read is cached as a blank frame
+// with a single dot, as the old helpers drew. Returns NULL only for an
+// unknown asset or when pinned frames leave no room.
+//*****************************************************************************
+const uint8_t* AssetManager_Get(AssetId asset, uint16_t frame);
+
+//*****************************************************************************
+// As AssetManager_Get(), and pin the frame so it is not evicted until a
+// matching AssetManager_Release(). Pins nest. Embedded frames never move,
+// so they are not pinned and releasing them does nothing.
+//*****************************************************************************
+const uint8_t* AssetManager_Acquire(AssetId asset, uint16_t frame);
+void AssetManager_Release(const uint8_t *frame);
+
+//*****************************************************************************
+// Draw a frame at (x, y), opaque and unscaled. A PackBits frame from the
+// archive is decoded straight into the display window, so background runs
+// go out as fills; other frames go to Display_DrawBitmapAsync(), pinned
+// until the transfer finishes, so call Display_WaitIdle() before drawing
+// over them.
+//*****************************************************************************
+void AssetManager_DrawFrame(AssetId asset, uint16_t frame, int x, int y,
+                            uint16_t color, uint16_t bg_color);
+
+//*****************************************************************************
+// Drop every frame that is not pinned, e.g. after new files are uploaded
+//*****************************************************************************
+void AssetManager_Flush(void);
+
+//*****************************************************************************
+// Hit/miss counters and cache occupancy
+//*****************************************************************************
+void AssetManager_GetStats(AssetStats *stats);
+void AssetManager_ResetStats(void);
+
+#if ASSET_MANAGER_BENCHMARK
+//*****************************************************************************
+// Draw every frame of each PackBits asset in the archive both decoded and
+// coded, and print the bytes and cycles per frame of each over UART
+//*****************************************************************************
+void AssetManager_Benchmark(void);
+#endif
+
+#endif /* ASSET_MANAGER_H_ */
@@ -1,5 +1,6 @@
 #include "simplelink.h"
 #include <string.h>
+#include "asset_manager.h"
 
 #define CHARACTER_DOUBLE_JUMP_WIDTH 13
 #define CHARACTER_DOUBLE_JUMP_HEIGHT 17
@@ -10,31 +11,6 @@
 
 // Function to get a pointer to a specific frame
 const uint8_t* get_character_double_jump_frame(uint16_t frame_index) {
-    static uint8_t frameBuffer[CHARACTER_DOUBLE_JUMP_FRAME_SIZE];
-
-    // Ensure valid frame index
-    if (frame_index >= CHARACTER_DOUBLE_JUMP_FRAME_COUNT) {
-        frame_index = 0;
-    }
-
-    // Format filename
-    char filename[64];
-    sprintf(filename, "/character_double_jumpFrames_%d.bin", frame_index);
-
-    // Try opening the file - cast to unsigned char*
-    long fileHandle;
-    int status = sl_FsOpen((unsigned char*)filename, FS_MODE_OPEN_READ, NULL, &fileHandle);
-
-    if (status < 0) {
-        // Default pattern
-        memset(frameBuffer, 0, CHARACTER_DOUBLE_JUMP_FRAME_SIZE);
-        frameBuffer[3] = 0x08;  // Default dot
-        return frameBuffer;
-    }
-
-    // Read data
-    long bytesRead = sl_FsRead(fileHandle, 0, frameBuffer, CHARACTER_DOUBLE_JUMP_FRAME_SIZE);
-    sl_FsClose(fileHandle, 0, 0, 0);
-
-    return frameBuffer;
+    // Cached by the asset manager: only a miss reads the file
+    return AssetManager_Get(ASSET_CHARACTER_DOUBLE_JUMP, frame_index);
 }
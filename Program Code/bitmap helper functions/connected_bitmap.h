@@ -1,6 +1,7 @@
 
 #include "simplelink.h"
 #include <string.h>
+#include "asset_manager.h"
 
 #define CONNECTED_WIDTH 128
 #define CONNECTED_HEIGHT 128
@@ -9,31 +10,6 @@
 
 // Function to get a pointer to a specific frame
 const uint8_t* get_connected_frame(uint16_t frame_index) {
-    static uint8_t frameBuffer[CONNECTED_FRAME_SIZE];
-
-    // Ensure valid frame index
-    if (frame_index >= CONNECTED_FRAME_COUNT) {
-        frame_index = 0;
-    }
-
-    // Format filename
-    char filename[64];
-    sprintf(filename, "/connectedFrames_0.bin");
-
-    // Try opening the file - cast to unsigned char*
-    long fileHandle;
-    int status = sl_FsOpen((unsigned char*)filename, FS_MODE_OPEN_READ, NULL, &fileHandle);
-
-    if (status < 0) {
-        // Default pattern
-        memset(frameBuffer, 0, CONNECTED_FRAME_SIZE);
-        frameBuffer[3] = 0x08;  // Default dot
-        return frameBuffer;
-    }
-
-    // Read data
-    long bytesRead = sl_FsRead(fileHandle, 0, frameBuffer, CONNECTED_FRAME_SIZE);
-    sl_FsClose(fileHandle, 0, 0, 0);
-
-    return frameBuffer;
+    // Cached by the asset manager: only a miss reads the file
+    return AssetManager_Get(ASSET_CONNECTED, frame_index);
 }
@@ -1,5 +1,6 @@
 #include "simplelink.h"
 #include <string.h>
+#include "asset_manager.h"
 
 #define PINPURPOSE_WIDTH 128
 #define PINPURPOSE_HEIGHT 128
@@ -9,32 +10,7 @@
 
 // Function to get a pointer to a specific frame
 const uint8_t* get_pinpurpose_frame(uint16_t frame_index) {
-    static uint8_t frameBuffer[PINPURPOSE_FRAME_SIZE];
-
-    // Ensure valid frame index
-    if (frame_index >= PINPURPOSE_FRAME_COUNT) {
-        frame_index = 0;
-    }
-
-    // Format filename
-    char filename[64];
-    sprintf(filename, "/pinpurposeFrames_%d.bin", frame_index);
-
-    // Try opening the file - cast to unsigned char*
-    long fileHandle;
-    int status = sl_FsOpen((unsigned char*)filename, FS_MODE_OPEN_READ, NULL, &fileHandle);
-
-    if (status < 0) {
-        // Default pattern
-        memset(frameBuffer, 0, PINPURPOSE_FRAME_SIZE);
-        frameBuffer[3] = 0x08;  // Default dot
-        return frameBuffer;
-    }
-
-    // Read data
-    long bytesRead = sl_FsRead(fileHandle, 0, frameBuffer, PINPURPOSE_FRAME_SIZE);
-    sl_FsClose(fileHandle, 0, 0, 0);
-
-    return frameBuffer;
+    // Cached by the asset manager: only a miss reads the file
+    return AssetManager_Get(ASSET_PINPURPOSE, frame_index);
 }
 
@@ -8,6 +8,13 @@
 
 #include <shared_defs.h>
 #include "pin.h"
+#include "framebuffer.h"
+#include "fixed3d.h"
+#include "fast_math.h"
+#include "physics_world.h"
+#include "accel_sampler.h"
+#include "accel_filter.h"
+#include "game_loop.h"
 
 
 #define SPI_IF_BIT_RATE  20000000
@@ -27,6 +34,8 @@
                                    if (SUCCESS != iRetVal) \
                                      return  iRetVal;}
 
+#define BUTTON1_PIN     0x40     // PIN_15
+#define BUTTON1_PORT    GPIOA2_BASE
 #define BUTTON2_PIN     0x20     // PIN_21
 #define BUTTON2_PORT    GPIOA1_BASE
 
@@ -47,17 +56,36 @@ bool Cube3D_ShouldExit(void)
 #define CUBE_SIZE               15
 #define NUM_VERTICES            8
 #define NUM_EDGES               12
+#define NUM_FACES               6
+
+// Set to 0 for the wireframe renderer
+#ifndef CUBE_RENDER_SOLID
+#define CUBE_RENDER_SOLID       1
+#endif
+
+// Light level of a face turned away from the light, out of 256
+#define SHADE_AMBIENT           72
+
+// At most three faces of a cube can face the camera at once
+#define MAX_VISIBLE_FACES       3
+
+// Perspective projection: focal length and camera distance
+#define FOCAL_LENGTH            200
+#define CAMERA_Z_OFFSET         100
 
 // Physics environment parameters - updated to match visual environment
 #define ENVIRONMENT_SIZE      128.0f
 #define ENVIRONMENT_MIN       80.0f
 #define ENVIRONMENT_MAX       128.0f
-#define GRAVITY_STRENGTH      1.1f    // Strength of gravity
-#define DAMPING               0.98f   // Velocity damping (energy loss)
-#define ANGULAR_DAMPING       0.25f   // Angular velocity damping
-#define RESTITUTION           0.5f    // Bounciness (0 = no bounce, 1 = perfect bounce)
-#define TIME_STEP             0.9f    // Physics time step
-#define STABILIZATION_STRENGTH 0.02f  // Strength of the stabilizing torque
+
+// Number of cubes in the sandbox, up to 16; 1 is the original single cube
+#ifndef CUBE_COUNT
+#define CUBE_COUNT            1
+#endif
+
+#if CUBE_COUNT > 16 || CUBE_COUNT > PHYSICS_MAX_BODIES
+#error "CUBE_COUNT exceeds the start positions or the physics body pool"
+#endif
 
 // Physics boundaries matching the visual environment walls
 #define PHYSICS_MIN_X         (-ENV_VISUAL_SIZE)
@@ -67,6 +95,25 @@ bool Cube3D_ShouldExit(void)
 #define PHYSICS_MIN_Z         (-ENV_VISUAL_SIZE + ENV_Z_OFFSET)
 #define PHYSICS_MAX_Z         (ENV_VISUAL_SIZE + ENV_Z_OFFSET)
 
+// Accelerometer sampling rate, and the filter every sample goes through
+#define CUBE_ACCEL_RATE_HZ      200
+#ifndef CUBE_ACCEL_FILTER
+#define CUBE_ACCEL_FILTER       ACCEL_FILTER_IIR
+#define CUBE_ACCEL_FILTER_PARAM 3
+#endif
+
+// Physics steps per second, paced on the GameLoop clock, and the most run in
+// one frame before the rest are dropped. A frame is drawn only after a step.
+#define CUBE_PHYSICS_STEP_HZ    60
+#define CUBE_MAX_STEPS_PER_FRAME 4
+
+// With SSD1351_STATS, how often to print the frame rate and bus traffic
+#define CUBE_STATS_PERIOD_MS    5000
+
+// Holding button 1 this long with the board lying flat stores a new
+// accelerometer calibration
+#define CUBE_CALIBRATE_HOLD_MS  2000
+
 // Environment wall colors - adjust these based on your display's color definitions
 #define WALL_COLOR            0x3186  // Dark gray color (adjust as needed)
 
@@ -83,30 +130,33 @@ extern uVectorEntry __vector_table;
 #endif
 
 
-// 3D Cube vertices (x, y, z)
-float g_cube_vertices[NUM_VERTICES][3] = {
-    {-CUBE_SIZE, -CUBE_SIZE, -CUBE_SIZE}, // 0: left-bottom-back
-    { CUBE_SIZE, -CUBE_SIZE, -CUBE_SIZE}, // 1: right-bottom-back
-    { CUBE_SIZE,  CUBE_SIZE, -CUBE_SIZE}, // 2: right-top-back
-    {-CUBE_SIZE,  CUBE_SIZE, -CUBE_SIZE}, // 3: left-top-back
-    {-CUBE_SIZE, -CUBE_SIZE,  CUBE_SIZE}, // 4: left-bottom-front
-    { CUBE_SIZE, -CUBE_SIZE,  CUBE_SIZE}, // 5: right-bottom-front
-    { CUBE_SIZE,  CUBE_SIZE,  CUBE_SIZE}, // 6: right-top-front
-    {-CUBE_SIZE,  CUBE_SIZE,  CUBE_SIZE}  // 7: left-top-front
+// 3D Cube vertices (x, y, z), Q16.16
+#define CUBE_FX                 FIXED3D_FROM_INT(CUBE_SIZE)
+fixed_t g_cube_vertices[NUM_VERTICES][3] = {
+    {-CUBE_FX, -CUBE_FX, -CUBE_FX}, // 0: left-bottom-back
+    { CUBE_FX, -CUBE_FX, -CUBE_FX}, // 1: right-bottom-back
+    { CUBE_FX,  CUBE_FX, -CUBE_FX}, // 2: right-top-back
+    {-CUBE_FX,  CUBE_FX, -CUBE_FX}, // 3: left-top-back
+    {-CUBE_FX, -CUBE_FX,  CUBE_FX}, // 4: left-bottom-front
+    { CUBE_FX, -CUBE_FX,  CUBE_FX}, // 5: right-bottom-front
+    { CUBE_FX,  CUBE_FX,  CUBE_FX}, // 6: right-top-front
+    {-CUBE_FX,  CUBE_FX,  CUBE_FX}  // 7: left-top-front
 };
 
 // Environment bounding box vertices (visual representation, positioned for optimal viewing)
 #define ENV_VISUAL_SIZE    60.0f  // Size of the environment box
 #define ENV_Z_OFFSET       60.0f  // Push environment toward back wall (higher Z = farther away)
-float g_environment_vertices[NUM_VERTICES][3] = {
-    {-ENV_VISUAL_SIZE, -ENV_VISUAL_SIZE, -ENV_VISUAL_SIZE + ENV_Z_OFFSET}, // 0: left-bottom-back
-    { ENV_VISUAL_SIZE, -ENV_VISUAL_SIZE, -ENV_VISUAL_SIZE + ENV_Z_OFFSET}, // 1: right-bottom-back
-    { ENV_VISUAL_SIZE,  ENV_VISUAL_SIZE, -ENV_VISUAL_SIZE + ENV_Z_OFFSET}, // 2: right-top-back
-    {-ENV_VISUAL_SIZE,  ENV_VISUAL_SIZE, -ENV_VISUAL_SIZE + ENV_Z_OFFSET}, // 3: left-top-back
-    {-ENV_VISUAL_SIZE, -ENV_VISUAL_SIZE,  ENV_VISUAL_SIZE + ENV_Z_OFFSET}, // 4: left-bottom-front
-    { ENV_VISUAL_SIZE, -ENV_VISUAL_SIZE,  ENV_VISUAL_SIZE + ENV_Z_OFFSET}, // 5: right-bottom-front
-    { ENV_VISUAL_SIZE,  ENV_VISUAL_SIZE,  ENV_VISUAL_SIZE + ENV_Z_OFFSET}, // 6: right-top-front
-    {-ENV_VISUAL_SIZE,  ENV_VISUAL_SIZE,  ENV_VISUAL_SIZE + ENV_Z_OFFSET}  // 7: left-top-front
+#define ENV_FX             FIXED3D_FROM_FLOAT(ENV_VISUAL_SIZE)
+#define ENV_Z_FX           FIXED3D_FROM_FLOAT(ENV_Z_OFFSET)
+fixed_t g_environment_vertices[NUM_VERTICES][3] = {
+    {-ENV_FX, -ENV_FX, -ENV_FX + ENV_Z_FX}, // 0: left-bottom-back
+    { ENV_FX, -ENV_FX, -ENV_FX + ENV_Z_FX}, // 1: right-bottom-back
+    { ENV_FX,  ENV_FX, -ENV_FX + ENV_Z_FX}, // 2: right-top-back
+    {-ENV_FX,  ENV_FX, -ENV_FX + ENV_Z_FX}, // 3: left-top-back
+    {-ENV_FX, -ENV_FX,  ENV_FX + ENV_Z_FX}, // 4: left-bottom-front
+    { ENV_FX, -ENV_FX,  ENV_FX + ENV_Z_FX}, // 5: right-bottom-front
+    { ENV_FX,  ENV_FX,  ENV_FX + ENV_Z_FX}, // 6: right-top-front
+    {-ENV_FX,  ENV_FX,  ENV_FX + ENV_Z_FX}  // 7: left-top-front
 };
 
 // Cube edges defined as pairs of vertex indices (same for cube and environment)
@@ -116,36 +166,95 @@ int g_cube_edges[NUM_EDGES][2] = {
     {0, 4}, {1, 5}, {2, 6}, {3, 7}  // connecting edges
 };
 
-// Projected 2D coordinates for cube
-int g_projected_vertices[NUM_VERTICES][2];
-int g_prev_projected_vertices[NUM_VERTICES][2];
+#if CUBE_RENDER_SOLID
+// Cube faces as vertex loops, in the same order as g_face_normals
+static const int g_cube_faces[NUM_FACES][4] = {
+    {0, 1, 2, 3},   // Back face (-Z)
+    {4, 5, 6, 7},   // Front face (+Z)
+    {0, 1, 5, 4},   // Bottom face (-Y)
+    {3, 2, 6, 7},   // Top face (+Y)
+    {0, 3, 7, 4},   // Left face (-X)
+    {1, 2, 6, 5}    // Right face (+X)
+};
+
+// Per-row extent of each solid cube drawn last frame (empty when left > right)
+static int16_t g_prev_silhouette_left[CUBE_COUNT][SCREEN_HEIGHT];
+static int16_t g_prev_silhouette_right[CUBE_COUNT][SCREEN_HEIGHT];
+
+// A visible face scan-converted for this frame: rows top..bottom of its
+// spans sit at first onwards in g_span_left/g_span_right
+typedef struct {
+    int16_t top;
+    int16_t bottom;
+    uint16_t first;
+    uint16_t shade;
+} FaceSpans;
+
+// Faces of each cube turned toward the camera this frame. The erase pass
+// scan-converts them once and the draw pass fills the stored spans.
+static FaceSpans g_visible_faces[CUBE_COUNT][MAX_VISIBLE_FACES];
+static uint8_t g_visible_face_count[CUBE_COUNT];
+
+// Span rows of every visible face this frame, enough for each cube to
+// cover the screen three times over. Empty rows hold left > right.
+static uint8_t g_span_left[CUBE_COUNT * MAX_VISIBLE_FACES * SCREEN_HEIGHT];
+static uint8_t g_span_right[CUBE_COUNT * MAX_VISIBLE_FACES * SCREEN_HEIGHT];
+static int g_span_rows_used;
+#else
+static int g_prev_projected_vertices[CUBE_COUNT][NUM_VERTICES][2];
+#endif
+
+// Projected 2D coordinates for each cube
+static int g_projected_vertices[CUBE_COUNT][NUM_VERTICES][2];
 
 // Projected 2D coordinates for environment walls
 int g_projected_env_vertices[NUM_VERTICES][2];
-int g_prev_projected_env_vertices[NUM_VERTICES][2];
+
+// Static layer: one bit per screen pixel covered by a wall edge
+static uint8_t g_wallMask[SCREEN_HEIGHT][SCREEN_WIDTH / 8];
 
 // Added flag to track first frame
 bool g_first_frame = true;
 
-// Current rotation angles
-float g_angleX = 0.0f;
-float g_angleY = 0.0f;
-float g_angleZ = 0.0f;
+// Normalized gravity direction from the last accelerometer reading
+static float g_gravityDir[3] = {0.0f, -1.0f, 0.0f};
+
+// Filtered accelerometer reading (Q8 counts) and where the filter is in the
+// sampler's stream
+static AccelFilter g_accelFilter;
+static int32_t g_accelFiltered[3];
+static unsigned long g_accelCursor = 0;
+static bool g_accelReady = false;
+
+// Samples read out of the sampler each frame, kept off the 2KB stack
+static AccelSample g_accelSamples[ACCEL_SAMPLER_BUFFER_SIZE];
 
-// Position of cube center (start in middle of physics environment)
-float g_positionX = SCREEN_CENTER_X;
-float g_positionY = SCREEN_CENTER_Y;
-float g_positionZ = 40.0f;  // Start in middle of Z range (0 to +80, so middle is +40)
+// Frame pacing
+static GameLoop g_loop;
 
-// Linear velocity of cube
-float g_velocityX = 0.0f;
-float g_velocityY = 0.0f;
-float g_velocityZ = 0.0f;
+#if SSD1351_STATS
+// Frames drawn, and ticks spent rendering and flushing them, since the last
+// report
+static unsigned long g_statsFrames;
+static uint32_t g_statsRenderTicks;
+static uint32_t g_statsStart;
+#endif
 
-// Angular velocity of cube
-float g_angularVelocityX = 0.0f;
-float g_angularVelocityY = 0.0f;
-float g_angularVelocityZ = 0.0f;
+// Button 1 hold tracking for the calibrate flat action
+static bool g_calibrateHeld = false;
+static bool g_calibrateDone = false;
+static uint32_t g_calibrateStart = 0;
+
+// Starting center of each cube in world coordinates. The first is where the
+// single cube always started; the rest sit on a grid clear of it.
+static const int8_t g_start_positions[16][3] = {
+    {  0,   0, 40},
+    {-40, -40, 80}, {  0, -40, 80}, { 40, -40, 80},
+    {-40,   0, 80}, {  0,   0, 80}, { 40,   0, 80},
+    {-40,  40, 80}, {  0,  40, 80}, { 40,  40, 80},
+    {-40, -40, 20}, {  0, -40, 20}, { 40, -40, 20},
+    {-40,  40, 20}, {  0,  40, 20}, { 40,  40, 20}
+};
 
 // Frame counter
 int frameCount = 0;
@@ -168,396 +277,212 @@ static void DisplayBanner(char * AppName)
 
 
 //*****************************************************************************
-// Apply rotations to a 3D point
+// Rotate and project one cube's vertices. The body position goes in the
+// matrix translation, so one transform places the cube in the world.
 //*****************************************************************************
-void RotatePoint(float x, float y, float z, float* rx, float* ry, float* rz)
+static void ProjectBody(int body, int (*projected)[2])
 {
-    // Apply X-axis rotation (pitch)
-    float temp_y = y;
-    float temp_z = z;
-    float temp_x = x;
-    y = temp_y * cosf(g_angleX) - temp_z * sinf(g_angleX);
-    z = temp_y * sinf(g_angleX) + temp_z * cosf(g_angleX);
-
-    // Apply Y-axis rotation (yaw)
-    temp_x = x;
-    temp_z = z;
-    x = temp_x * cosf(g_angleY) + temp_z * sinf(g_angleY);
-    z = -temp_x * sinf(g_angleY) + temp_z * cosf(g_angleY);
-
-    // Apply Z-axis rotation (roll)
-    temp_x = x;
-    temp_y = y;
-    x = temp_x * cosf(g_angleZ) - temp_y * sinf(g_angleZ);
-    y = temp_x * sinf(g_angleZ) + temp_y * cosf(g_angleZ);
-
-    *rx = x;
-    *ry = y;
-    *rz = z;
-}
+    Fixed3D_Matrix mat = *PhysicsWorld_GetRotation(body);
+    fixed_t world[NUM_VERTICES][3];
+    float x, y, z;
+    int i;
 
-//*****************************************************************************
-// Project a 3D point to 2D screen space using perspective projection
-//*****************************************************************************
-void ProjectPoint(float x, float y, float z, int* px, int* py)
-{
-    // First translate the point based on the cube's position
-    x += g_positionX - SCREEN_CENTER_X;
-    y += g_positionY - SCREEN_CENTER_Y;
-    z += g_positionZ;
-
-    // Perspective factor - adjust as needed
-    float f = 200.0f;
-    float z_offset = 100.0f;
-
-    // Apply perspective projection only if z+z_offset is not zero or very small
-    if (fabsf(z + z_offset) > 0.001f) {
-        float perspective = f / (z + z_offset);
-        *px = SCREEN_CENTER_X + (int)(x * perspective);
-        *py = SCREEN_CENTER_Y - (int)(y * perspective);  // Y is inverted in screen space
-    } else {
-        *px = SCREEN_CENTER_X + (int)x;
-        *py = SCREEN_CENTER_Y - (int)y;
+    PhysicsWorld_GetPosition(body, &x, &y, &z);
+    mat.t[0] = FIXED3D_FROM_FLOAT(x);
+    mat.t[1] = FIXED3D_FROM_FLOAT(y);
+    mat.t[2] = FIXED3D_FROM_FLOAT(z);
+
+    Fixed3D_TransformPoints(&mat, g_cube_vertices, world, NUM_VERTICES);
+    for (i = 0; i < NUM_VERTICES; i++) {
+        Fixed3D_Project(world[i][0], world[i][1], world[i][2], FOCAL_LENGTH, CAMERA_Z_OFFSET,
+                        SCREEN_CENTER_X, SCREEN_CENTER_Y, &projected[i][0], &projected[i][1]);
     }
 }
 
 //*****************************************************************************
 // Project environment wall point (fixed in world space)
 //*****************************************************************************
-void ProjectEnvironmentPoint(float x, float y, float z, int* px, int* py)
+void ProjectEnvironmentPoint(fixed_t x, fixed_t y, fixed_t z, int* px, int* py)
 {
     // Environment walls are fixed in world space - don't translate by cube position
     // Only apply perspective projection with a fixed viewpoint
+    Fixed3D_Project(x, y, z, FOCAL_LENGTH, CAMERA_Z_OFFSET,
+                    SCREEN_CENTER_X, SCREEN_CENTER_Y, px, py);
 
-    // Perspective factor - same as cube projection
-    float f = 200.0f;
-    float z_offset = 100.0f;
-
-    // Apply perspective projection
-    if (fabsf(z + z_offset) > 0.001f) {
-        float perspective = f / (z + z_offset);
-        float projectedX = x * perspective;
-        float projectedY = y * perspective;
-
-        // Clamp to reasonable screen bounds to prevent extreme coordinates
-        if (projectedX > 200.0f) projectedX = 200.0f;
-        if (projectedX < -200.0f) projectedX = -200.0f;
-        if (projectedY > 200.0f) projectedY = 200.0f;
-        if (projectedY < -200.0f) projectedY = -200.0f;
-
-        *px = SCREEN_CENTER_X + (int)projectedX;
-        *py = SCREEN_CENTER_Y - (int)projectedY;  // Y is inverted in screen space
-    } else {
-        *px = SCREEN_CENTER_X + (int)x;
-        *py = SCREEN_CENTER_Y - (int)y;
-    }
-
-    // Additional bounds checking for final screen coordinates
+    // Bounds checking for final screen coordinates
     if (*px < 0) *px = 0;
     if (*px >= SCREEN_WIDTH) *px = SCREEN_WIDTH - 1;
     if (*py < 0) *py = 0;
     if (*py >= SCREEN_HEIGHT) *py = SCREEN_HEIGHT - 1;
 }
 
+// Define unit vectors for the cube's faces (in local space)
+fixed_t g_face_normals[6][3] = {
+    { 0,             0,            -FIXED3D_ONE},  // Back face (-Z)
+    { 0,             0,             FIXED3D_ONE},  // Front face (+Z)
+    { 0,            -FIXED3D_ONE,   0},            // Bottom face (-Y)
+    { 0,             FIXED3D_ONE,   0},            // Top face (+Y)
+    {-FIXED3D_ONE,   0,             0},            // Left face (-X)
+    { FIXED3D_ONE,   0,             0}             // Right face (+X)
+};
+
 //*****************************************************************************
-// Check for and resolve collisions between cube vertices and environment
+// Update physics simulation
 //*****************************************************************************
-void CheckAndResolveCollisions()
+void UpdatePhysics()
 {
-    int i;
-    float rx, ry, rz;
-    bool collisionDetected = false;
-    float collisionNormalX = 0.0f, collisionNormalY = 0.0f, collisionNormalZ = 0.0f;
-
-    // Transform and check each vertex
-    for (i = 0; i < NUM_VERTICES; i++) {
-        // Apply rotation
-        RotatePoint(
-            g_cube_vertices[i][0],
-            g_cube_vertices[i][1],
-            g_cube_vertices[i][2],
-            &rx, &ry, &rz
-        );
-
-        // Translate to world position
-        float worldX = g_positionX + rx - SCREEN_CENTER_X;  // Convert to world coordinates
-        float worldY = g_positionY + ry - SCREEN_CENTER_Y;
-        float worldZ = g_positionZ + rz;
-
-        // Check collision with environment boundaries using physics bounds
-        if (worldX < PHYSICS_MIN_X) {
-            collisionDetected = true;
-            collisionNormalX += 1.0f;  // Normal pointing right
+    // The accelerometer readings directly define the gravity direction
+    // Normalize accelerometer readings to create a gravity direction vector
+    float gravityX = g_accelFiltered[1];  // Flip sign if needed based on orientation
+    float gravityY = -g_accelFiltered[2];  // Flip sign if needed based on orientation
+    float gravityZ = -g_accelFiltered[0];  // Flip sign if needed based on orientation
 
-            // Push cube back inside boundary
-            float penetration = PHYSICS_MIN_X - worldX;
-            g_positionX += penetration;
-        }
-        else if (worldX > PHYSICS_MAX_X) {
-            collisionDetected = true;
-            collisionNormalX += -1.0f;  // Normal pointing left
+    // Calculate magnitude of the gravity vector
+    float gravityMagnitude = FastMath_Sqrt(gravityX * gravityX +
+                                 gravityY * gravityY +
+                                 gravityZ * gravityZ);
 
-            // Push cube back inside boundary
-            float penetration = worldX - PHYSICS_MAX_X;
-            g_positionX -= penetration;
-        }
+    // Prevent division by zero
+    if (gravityMagnitude > 0.001f) {
+        // Normalize gravity vector
+        gravityX /= gravityMagnitude;
+        gravityY /= gravityMagnitude;
+        gravityZ /= gravityMagnitude;
 
-        if (worldY < PHYSICS_MIN_Y) {
-            collisionDetected = true;
-            collisionNormalY += 1.0f;  // Normal pointing down
+        // Keep the direction for shading the solid cube
+        g_gravityDir[0] = gravityX;
+        g_gravityDir[1] = gravityY;
+        g_gravityDir[2] = gravityZ;
+    } else {
+        // No usable reading: the cubes just coast this step
+        gravityX = 0.0f;
+        gravityY = 0.0f;
+        gravityZ = 0.0f;
+    }
 
-            // Push cube back inside boundary
-            float penetration = PHYSICS_MIN_Y - worldY;
-            g_positionY += penetration;
-        }
-        else if (worldY > PHYSICS_MAX_Y) {
-            collisionDetected = true;
-            collisionNormalY += -1.0f;  // Normal pointing up
+    // Gravity, stabilizing torque, integration and all collisions
+    PhysicsWorld_Step(gravityX, gravityY, gravityZ);
+}
 
-            // Push cube back inside boundary
-            float penetration = worldY - PHYSICS_MAX_Y;
-            g_positionY -= penetration;
-        }
+//*****************************************************************************
+// Walk a line with the same Bresenham steps as drawLine() and hand each
+// maximal horizontal (shallow) or vertical (steep) run to fn
+//*****************************************************************************
+typedef void (*LineSpanFn)(int x, int y, int length, bool vertical);
 
-        if (worldZ < PHYSICS_MIN_Z) {
-            collisionDetected = true;
-            collisionNormalZ += 1.0f;  // Normal pointing forward
+static void WalkLineSpans(int x0, int y0, int x1, int y1, LineSpanFn fn)
+{
+    int steep, dx, dy, err, ystep, runStart, tmp;
 
-            // Push cube back inside boundary
-            float penetration = PHYSICS_MIN_Z - worldZ;
-            g_positionZ += penetration;
-        }
-        else if (worldZ > PHYSICS_MAX_Z) {
-            collisionDetected = true;
-            collisionNormalZ += -1.0f;  // Normal pointing backward
+    if (y0 == y1) {
+        if (x0 > x1) { tmp = x0; x0 = x1; x1 = tmp; }
+        fn(x0, y0, x1 - x0 + 1, false);
+        return;
+    }
+    if (x0 == x1) {
+        if (y0 > y1) { tmp = y0; y0 = y1; y1 = tmp; }
+        fn(x0, y0, y1 - y0 + 1, true);
+        return;
+    }
 
-            // Push cube back inside boundary
-            float penetration = worldZ - PHYSICS_MAX_Z;
-            g_positionZ -= penetration;
-        }
+    steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) {
+        tmp = x0; x0 = y0; y0 = tmp;
+        tmp = x1; x1 = y1; y1 = tmp;
+    }
+    if (x0 > x1) {
+        tmp = x0; x0 = x1; x1 = tmp;
+        tmp = y0; y0 = y1; y1 = tmp;
     }
 
-    // Handle collision response if any detected
-    if (collisionDetected) {
-        // Normalize the collision normal (could be from multiple vertices)
-        float normalLength = sqrtf(collisionNormalX * collisionNormalX +
-                                 collisionNormalY * collisionNormalY +
-                                 collisionNormalZ * collisionNormalZ);
-
-        if (normalLength > 0.001f) {
-            collisionNormalX /= normalLength;
-            collisionNormalY /= normalLength;
-            collisionNormalZ /= normalLength;
-
-            // Calculate dot product of velocity and normal
-            float dotProduct = g_velocityX * collisionNormalX +
-                             g_velocityY * collisionNormalY +
-                             g_velocityZ * collisionNormalZ;
-
-            // Reflect velocity based on collision normal
-            if (dotProduct < 0) {
-                g_velocityX -= (1.0f + RESTITUTION) * dotProduct * collisionNormalX;
-                g_velocityY -= (1.0f + RESTITUTION) * dotProduct * collisionNormalY;
-                g_velocityZ -= (1.0f + RESTITUTION) * dotProduct * collisionNormalZ;
-
-                // Add some angular velocity change based on collision point
-                // This is a simplified approach to add some rotation on impact
-                g_angularVelocityX += (rand() % 100) / 1000.0f - 0.05f;
-                g_angularVelocityY += (rand() % 100) / 1000.0f - 0.05f;
-                g_angularVelocityZ += (rand() % 100) / 1000.0f - 0.05f;
+    dx = x1 - x0;
+    dy = abs(y1 - y0);
+    err = dx / 2;
+    ystep = (y0 < y1) ? 1 : -1;
+
+    runStart = x0;
+    for (; x0 <= x1; x0++) {
+        err -= dy;
+        if (err < 0 || x0 == x1) {
+            if (steep) {
+                fn(y0, runStart, x0 - runStart + 1, true);
+            } else {
+                fn(runStart, y0, x0 - runStart + 1, false);
+            }
+            runStart = x0 + 1;
+            if (err < 0) {
+                y0 += ystep;
+                err += dx;
             }
         }
     }
 }
 
-
-
-// Define unit vectors for the cube's faces (in local space)
-float g_face_normals[6][3] = {
-    { 0.0f,  0.0f, -1.0f},  // Back face (-Z)
-    { 0.0f,  0.0f,  1.0f},  // Front face (+Z)
-    { 0.0f, -1.0f,  0.0f},  // Bottom face (-Y)
-    { 0.0f,  1.0f,  0.0f},  // Top face (+Y)
-    {-1.0f,  0.0f,  0.0f},  // Left face (-X)
-    { 1.0f,  0.0f,  0.0f}   // Right face (+X)
-};
-
-// [Keep other global variables as they are]
-
-//*****************************************************************************
-// Rotate a direction vector by the cube's current orientation
-//*****************************************************************************
-void RotateVector(float x, float y, float z, float* rx, float* ry, float* rz)
+static bool IsWallPixel(int x, int y)
 {
-    // Similar to RotatePoint but doesn't apply translation
-    // Apply X-axis rotation (pitch)
-    float temp_y = y;
-    float temp_z = z;
-    y = temp_y * cosf(g_angleX) - temp_z * sinf(g_angleX);
-    z = temp_y * sinf(g_angleX) + temp_z * cosf(g_angleX);
-
-    // Apply Y-axis rotation (yaw)
-    float temp_x = x;
-    temp_z = z;
-    x = temp_x * cosf(g_angleY) + temp_z * sinf(g_angleY);
-    z = -temp_x * sinf(g_angleY) + temp_z * cosf(g_angleY);
-
-    // Apply Z-axis rotation (roll)
-    temp_x = x;
-    temp_y = y;
-    x = temp_x * cosf(g_angleZ) - temp_y * sinf(g_angleZ);
-    y = temp_x * sinf(g_angleZ) + temp_y * cosf(g_angleZ);
-
-    *rx = x;
-    *ry = y;
-    *rz = z;
+    return (g_wallMask[y][x >> 3] & (0x80 >> (x & 7))) != 0;
 }
 
-//*****************************************************************************
-// Calculate torque to stabilize cube onto a face
-//*****************************************************************************
-void CalculateStabilizingTorque(float gravityX, float gravityY, float gravityZ,
-                               float* torqueX, float* torqueY, float* torqueZ)
+// Record a wall span in the mask, clipped to the screen
+static void MarkWallSpan(int x, int y, int length, bool vertical)
 {
     int i;
-    float bestAlignment = -1.0f;  // Dot product closest to -1 (face down)
-    int bestFace = -1;
-    float worldNormalX, worldNormalY, worldNormalZ;
-
-    // Find which face is most closely aligned with gravity (facing down)
-    for (i = 0; i < 6; i++) {
-        // Transform face normal to world space
-        RotateVector(
-            g_face_normals[i][0],
-            g_face_normals[i][1],
-            g_face_normals[i][2],
-            &worldNormalX, &worldNormalY, &worldNormalZ
-        );
-
-        // Calculate dot product with gravity vector (negative means facing down)
-        float dotProduct = worldNormalX * gravityX +
-                          worldNormalY * gravityY +
-                          worldNormalZ * gravityZ;
 
-        // Check if this face is better aligned with gravity direction
-        if (dotProduct < bestAlignment) {
-            bestAlignment = dotProduct;
-            bestFace = i;
-        }
-    }
-
-    // If we found a "best" face and it's not perfectly aligned
-    if (bestFace != -1 && bestAlignment > -0.99f) {
-        // Get the world space normal of the best face
-        RotateVector(
-            g_face_normals[bestFace][0],
-            g_face_normals[bestFace][1],
-            g_face_normals[bestFace][2],
-            &worldNormalX, &worldNormalY, &worldNormalZ
-        );
+    for (i = 0; i < length; i++) {
+        int px = vertical ? x : x + i;
+        int py = vertical ? y + i : y;
 
-        // Calculate cross product between face normal and gravity to get rotation axis
-        float crossX = worldNormalY * gravityZ - worldNormalZ * gravityY;
-        float crossY = worldNormalZ * gravityX - worldNormalX * gravityZ;
-        float crossZ = worldNormalX * gravityY - worldNormalY * gravityX;
-
-        // Normalize the cross product
-        float crossLength = sqrtf(crossX * crossX + crossY * crossY + crossZ * crossZ);
-        if (crossLength > 0.001f) {
-            crossX /= crossLength;
-            crossY /= crossLength;
-            crossZ /= crossLength;
-
-            // The magnitude of rotation should be proportional to the misalignment
-            float rotationMagnitude = acosf(-bestAlignment) * STABILIZATION_STRENGTH;
-
-            // Set the torque
-            *torqueX = crossX * rotationMagnitude;
-            *torqueY = crossY * rotationMagnitude;
-            *torqueZ = crossZ * rotationMagnitude;
-        } else {
-            // If cross product is zero, no torque needed
-            *torqueX = 0.0f;
-            *torqueY = 0.0f;
-            *torqueZ = 0.0f;
+        if (px >= 0 && px < SCREEN_WIDTH && py >= 0 && py < SCREEN_HEIGHT) {
+            g_wallMask[py][px >> 3] |= 0x80 >> (px & 7);
         }
-    } else {
-        // If already aligned or no best face, no torque needed
-        *torqueX = 0.0f;
-        *torqueY = 0.0f;
-        *torqueZ = 0.0f;
     }
 }
 
-//*****************************************************************************
-// Update physics simulation
-//*****************************************************************************
-void UpdatePhysics()
+// Erase a span of an old cube edge, putting back the wall pixels it covered.
+// The span is split into runs that are all wall or all background.
+static void EraseSpan(int x, int y, int length, bool vertical)
 {
-    // 1. The accelerometer readings directly define the gravity direction
-    // Normalize accelerometer readings to create a gravity direction vector
-    float gravityX = g_iAccelY;  // Flip sign if needed based on orientation
-    float gravityY = -g_iAccelZ;  // Flip sign if needed based on orientation
-    float gravityZ = -g_iAccelX;  // Flip sign if needed based on orientation
+    int i = 0;
 
-    // Calculate magnitude of the gravity vector
-    float gravityMagnitude = sqrtf(gravityX * gravityX +
-                                 gravityY * gravityY +
-                                 gravityZ * gravityZ);
-
-    // Prevent division by zero
-    if (gravityMagnitude > 0.001f) {
-        // Normalize gravity vector
-        gravityX /= gravityMagnitude;
-        gravityY /= gravityMagnitude;
-        gravityZ /= gravityMagnitude;
-
-        // Apply gravity to velocity (scaled by gravity strength)
-        g_velocityX += gravityX * GRAVITY_STRENGTH * TIME_STEP;
-        g_velocityY += gravityY * GRAVITY_STRENGTH * TIME_STEP;
-        g_velocityZ += gravityZ * GRAVITY_STRENGTH * TIME_STEP;
-
-        // 2. Calculate stabilizing torque to align cube with gravity
-        float torqueX, torqueY, torqueZ;
-        CalculateStabilizingTorque(gravityX, gravityY, gravityZ, &torqueX, &torqueY, &torqueZ);
-
-        // Apply stabilizing torque to angular velocity
-        g_angularVelocityX += torqueX;
-        g_angularVelocityY += torqueY;
-        g_angularVelocityZ += torqueZ;
+    // Clip to the screen; the mask only covers visible pixels
+    if (vertical) {
+        if (x < 0 || x >= SCREEN_WIDTH) return;
+        if (y < 0) { length += y; y = 0; }
+        if (y + length > SCREEN_HEIGHT) length = SCREEN_HEIGHT - y;
+    } else {
+        if (y < 0 || y >= SCREEN_HEIGHT) return;
+        if (x < 0) { length += x; x = 0; }
+        if (x + length > SCREEN_WIDTH) length = SCREEN_WIDTH - x;
     }
 
-    // Apply damping to velocities (simulates air resistance/friction)
-    g_velocityX *= DAMPING;
-    g_velocityY *= DAMPING;
-    g_velocityZ *= DAMPING;
-
-    // 3. Update position based on velocity
-    g_positionX += g_velocityX * TIME_STEP;
-    g_positionY += g_velocityY * TIME_STEP;
-    g_positionZ += g_velocityZ * TIME_STEP;
+    while (i < length) {
+        int start = i;
+        bool wall = vertical ? IsWallPixel(x, y + i) : IsWallPixel(x + i, y);
 
-    // 4. Update angular velocity with damping
-    g_angularVelocityX *= ANGULAR_DAMPING;
-    g_angularVelocityY *= ANGULAR_DAMPING;
-    g_angularVelocityZ *= ANGULAR_DAMPING;
+        do {
+            i++;
+        } while (i < length &&
+                 (vertical ? IsWallPixel(x, y + i) : IsWallPixel(x + i, y)) == wall);
 
-    // 5. Update orientation based on angular velocity
-    g_angleX += g_angularVelocityX * TIME_STEP;
-    g_angleY += g_angularVelocityY * TIME_STEP;
-    g_angleZ += g_angularVelocityZ * TIME_STEP;
-
-    // 6. Collision detection and response with environment boundaries
-    CheckAndResolveCollisions();
+        if (vertical) {
+            drawFastVLine(x, y + start, i - start, wall ? WALL_COLOR : BLACK);
+        } else {
+            drawFastHLine(x + start, y, i - start, wall ? WALL_COLOR : BLACK);
+        }
+    }
 }
 
 //*****************************************************************************
-// Render the environment bounding walls as wireframe with optimized line drawing
+// Draw the environment bounding walls once and build the wall-pixel mask.
+// The walls are fixed in world space, so they form a static layer that only
+// needs repairing where an erased cube edge crossed them.
 //*****************************************************************************
 void RenderEnvironment(uint16_t color)
 {
     int i;
 
+    memset(g_wallMask, 0, sizeof(g_wallMask));
+
     // Calculate projected vertices for environment walls (fixed in world space)
     for (i = 0; i < NUM_VERTICES; i++) {
         ProjectEnvironmentPoint(
@@ -569,47 +494,6 @@ void RenderEnvironment(uint16_t color)
         );
     }
 
-    // If not the first frame, erase the previous environment frame
-    if (!g_first_frame) {
-        // Draw black lines over previous environment edges
-        for (i = 0; i < NUM_EDGES; i++) {
-            int v1 = g_cube_edges[i][0];  // Reuse cube edge topology
-            int v2 = g_cube_edges[i][1];
-
-            int x1 = g_prev_projected_env_vertices[v1][0];
-            int y1 = g_prev_projected_env_vertices[v1][1];
-            int x2 = g_prev_projected_env_vertices[v2][0];
-            int y2 = g_prev_projected_env_vertices[v2][1];
-
-            // Skip lines that are suspiciously long (likely projection errors)
-            int dx = abs(x2 - x1);
-            int dy = abs(y2 - y1);
-            if (dx > SCREEN_WIDTH || dy > SCREEN_HEIGHT) {
-                continue; // Skip this line
-            }
-
-            // Use optimized functions for horizontal/vertical lines
-            if (y1 == y2 && dx > 0) {
-                // Horizontal line
-                int startX = (x1 < x2) ? x1 : x2;
-                int width = dx + 1;
-                drawFastHLine(startX, y1, width, BLACK);
-            }
-            else if (x1 == x2 && dy > 0) {
-                // Vertical line
-                int startY = (y1 < y2) ? y1 : y2;
-                int height = dy + 1;
-                drawFastVLine(x1, startY, height, BLACK);
-            }
-            else if (dx > 0 || dy > 0) {
-                // Diagonal line - use regular line function
-                drawLine(x1, y1, x2, y2, BLACK);
-            }
-            // Skip zero-length lines
-        }
-    }
-
-    // Draw new environment edges with optimized line functions
     for (i = 0; i < NUM_EDGES; i++) {
         int v1 = g_cube_edges[i][0];  // Reuse cube edge topology
         int v2 = g_cube_edges[i][1];
@@ -626,91 +510,280 @@ void RenderEnvironment(uint16_t color)
             continue; // Skip this line
         }
 
-        // Use optimized functions for horizontal/vertical lines
-        if (y1 == y2 && dx > 0) {
-            // Horizontal line
-            int startX = (x1 < x2) ? x1 : x2;
-            int width = dx + 1;
-            drawFastHLine(startX, y1, width, color);
+        drawLine(x1, y1, x2, y2, color);
+        WalkLineSpans(x1, y1, x2, y2, MarkWallSpan);
+    }
+}
+
+#if CUBE_RENDER_SOLID
+//*****************************************************************************
+// Scan-convert one projected quad into per-row [left, right] spans, clipped
+// to the screen rows. Rows the quad does not touch are left empty.
+//*****************************************************************************
+static void ScanFace(int (*projected)[2], const int face[4], int16_t* left, int16_t* right,
+                     int* top, int* bottom)
+{
+    int i, y;
+    int minY = SCREEN_HEIGHT, maxY = -1;
+
+    for (i = 0; i < 4; i++) {
+        int ya = projected[face[i]][1];
+        if (ya < minY) minY = ya;
+        if (ya > maxY) maxY = ya;
+    }
+    if (minY < 0) minY = 0;
+    if (maxY >= SCREEN_HEIGHT) maxY = SCREEN_HEIGHT - 1;
+
+    for (y = minY; y <= maxY; y++) {
+        left[y] = SCREEN_WIDTH;
+        right[y] = -1;
+    }
+
+    for (i = 0; i < 4; i++) {
+        int xa = projected[face[i]][0];
+        int ya = projected[face[i]][1];
+        int xb = projected[face[(i + 1) & 3]][0];
+        int yb = projected[face[(i + 1) & 3]][1];
+        int y0 = (ya < yb) ? ya : yb;
+        int y1 = (ya < yb) ? yb : ya;
+
+        if (y0 < minY) y0 = minY;
+        if (y1 > maxY) y1 = maxY;
+
+        for (y = y0; y <= y1; y++) {
+            int x;
+            if (ya == yb) {
+                // Horizontal edge: both endpoints lie on this row
+                x = (xa < xb) ? xa : xb;
+                if (x < left[y]) left[y] = x;
+                x = (xa < xb) ? xb : xa;
+            } else {
+                x = xa + (xb - xa) * (y - ya) / (yb - ya);
+            }
+            if (x < left[y]) left[y] = x;
+            if (x > right[y]) right[y] = x;
         }
-        else if (x1 == x2 && dy > 0) {
-            // Vertical line
-            int startY = (y1 < y2) ? y1 : y2;
-            int height = dy + 1;
-            drawFastVLine(x1, startY, height, color);
+    }
+
+    for (y = minY; y <= maxY; y++) {
+        if (left[y] < 0) left[y] = 0;
+        if (right[y] >= SCREEN_WIDTH) right[y] = SCREEN_WIDTH - 1;
+    }
+
+    *top = minY;
+    *bottom = maxY;
+}
+
+// Scale each RGB565 channel of color by level/256
+static uint16_t ShadeColor(uint16_t color, int level)
+{
+    unsigned int r = (((color >> 11) & 0x1F) * level) >> 8;
+    unsigned int g = (((color >> 5) & 0x3F) * level) >> 8;
+    unsigned int b = ((color & 0x1F) * level) >> 8;
+
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+//*****************************************************************************
+// Cull and shade one cube's faces with the rotated face normals, so at most
+// three faces are scan-converted, keep their spans for DrawSolidCube(), then
+// clear the parts of its previous silhouette rows the new faces do not cover
+//*****************************************************************************
+static void PrepareSolidCube(int body, uint16_t color)
+{
+    // Static: together these would take over half of the 2 KB stack
+    static int16_t faceLeft[SCREEN_HEIGHT], faceRight[SCREEN_HEIGHT];
+    static int16_t silLeft[SCREEN_HEIGHT], silRight[SCREEN_HEIGHT];
+    static fixed_t worldNormals[NUM_FACES][3];
+    int16_t* prevLeft = g_prev_silhouette_left[body];
+    int16_t* prevRight = g_prev_silhouette_right[body];
+    float viewX, viewY, viewZ;
+    int f, y;
+
+    PhysicsWorld_GetPosition(body, &viewX, &viewY, &viewZ);
+    viewZ += CAMERA_Z_OFFSET;
+    Fixed3D_TransformVectors(PhysicsWorld_GetRotation(body), g_face_normals, worldNormals, NUM_FACES);
+
+    for (y = 0; y < SCREEN_HEIGHT; y++) {
+        silLeft[y] = SCREEN_WIDTH;
+        silRight[y] = -1;
+    }
+
+    g_visible_face_count[body] = 0;
+    for (f = 0; f < NUM_FACES && g_visible_face_count[body] < MAX_VISIBLE_FACES; f++) {
+        float nx = FIXED3D_TO_FLOAT(worldNormals[f][0]);
+        float ny = FIXED3D_TO_FLOAT(worldNormals[f][1]);
+        float nz = FIXED3D_TO_FLOAT(worldNormals[f][2]);
+        FaceSpans* spans;
+        float lit;
+        int top, bottom;
+
+        // The face center sits CUBE_SIZE along its normal; the face is
+        // visible when it points back toward the camera
+        if (nx * viewX + ny * viewY + nz * viewZ + CUBE_SIZE >= 0.0f) {
+            continue;
         }
-        else if (dx > 0 || dy > 0) {
-            // Diagonal line - use regular line function
-            drawLine(x1, y1, x2, y2, color);
+
+        // Light comes from "up", opposite the measured gravity
+        lit = -(nx * g_gravityDir[0] + ny * g_gravityDir[1] + nz * g_gravityDir[2]);
+        if (lit < 0.0f) lit = 0.0f;
+
+        ScanFace(g_projected_vertices[body], g_cube_faces[f], faceLeft, faceRight, &top, &bottom);
+
+        spans = &g_visible_faces[body][g_visible_face_count[body]++];
+        spans->top = top;
+        spans->bottom = bottom;
+        spans->first = g_span_rows_used;
+        spans->shade = ShadeColor(color, SHADE_AMBIENT + (int)(lit * (256 - SHADE_AMBIENT)));
+
+        for (y = top; y <= bottom; y++) {
+            if (faceLeft[y] > faceRight[y]) {
+                g_span_left[g_span_rows_used] = 1;
+                g_span_right[g_span_rows_used++] = 0;
+                continue;
+            }
+            g_span_left[g_span_rows_used] = faceLeft[y];
+            g_span_right[g_span_rows_used++] = faceRight[y];
+
+            if (faceLeft[y] < silLeft[y]) silLeft[y] = faceLeft[y];
+            if (faceRight[y] > silRight[y]) silRight[y] = faceRight[y];
         }
-        // Skip zero-length lines
     }
 
-    // Copy current environment vertices to previous for next frame
-    for (i = 0; i < NUM_VERTICES; i++) {
-        g_prev_projected_env_vertices[i][0] = g_projected_env_vertices[i][0];
-        g_prev_projected_env_vertices[i][1] = g_projected_env_vertices[i][1];
+    // Clear what the old silhouette covered outside the new one
+    for (y = 0; y < SCREEN_HEIGHT; y++) {
+        int pl = prevLeft[y];
+        int pr = prevRight[y];
+
+        if (pl <= pr) {
+            if (silLeft[y] > silRight[y]) {
+                EraseSpan(pl, y, pr - pl + 1, false);
+            } else {
+                if (pl < silLeft[y]) {
+                    int end = (pr < silLeft[y] - 1) ? pr : silLeft[y] - 1;
+                    EraseSpan(pl, y, end - pl + 1, false);
+                }
+                if (pr > silRight[y]) {
+                    int start = (pl > silRight[y] + 1) ? pl : silRight[y] + 1;
+                    EraseSpan(start, y, pr - start + 1, false);
+                }
+            }
+        }
+
+        prevLeft[y] = silLeft[y];
+        prevRight[y] = silRight[y];
+    }
+}
+
+// Fill the spans PrepareSolidCube() kept for this cube's visible faces
+static void DrawSolidCube(int body)
+{
+    int f, y;
+
+    for (f = 0; f < g_visible_face_count[body]; f++) {
+        const FaceSpans* spans = &g_visible_faces[body][f];
+        const uint8_t* left = &g_span_left[spans->first];
+        const uint8_t* right = &g_span_right[spans->first];
+
+        for (y = spans->top; y <= spans->bottom; y++, left++, right++) {
+            if (*left <= *right) {
+                drawFastHLine(*left, y, *right - *left + 1, spans->shade);
+            }
+        }
+    }
+}
+
+//*****************************************************************************
+// Render every cube as filled, flat-shaded faces. All old silhouettes are
+// cleared before anything is drawn, so erasing one cube never eats into
+// another; the cubes are then painted farthest first.
+//*****************************************************************************
+static void RenderSolidCubes(uint16_t color)
+{
+    int order[CUBE_COUNT];
+    float depth[CUBE_COUNT];
+    float x, y;
+    int b, i, j;
+
+    g_span_rows_used = 0;
+    for (b = 0; b < CUBE_COUNT; b++) {
+        PrepareSolidCube(b, color);
+
+        // Insertion sort by depth, farthest first
+        PhysicsWorld_GetPosition(b, &x, &y, &depth[b]);
+        for (i = b; i > 0 && depth[order[i - 1]] < depth[b]; i--) {
+            order[i] = order[i - 1];
+        }
+        order[i] = b;
+    }
+
+    for (j = 0; j < CUBE_COUNT; j++) {
+        DrawSolidCube(order[j]);
     }
 }
+#endif // CUBE_RENDER_SOLID
 
 //*****************************************************************************
-// Render the 3D cube - MODIFIED to erase previous frame
+// Render the 3D cubes - MODIFIED to erase previous frame
 //*****************************************************************************
 void RenderCube(uint16_t color)
 {
-    int i;
-    float rx, ry, rz;
+    int b, i;
 
     // Calculate projected vertices for current frame
-    for (i = 0; i < NUM_VERTICES; i++) {
-        // Apply rotation
-        RotatePoint(
-            g_cube_vertices[i][0],
-            g_cube_vertices[i][1],
-            g_cube_vertices[i][2],
-            &rx, &ry, &rz
-        );
-
-        // Project to 2D
-        ProjectPoint(rx, ry, rz,
-                    &g_projected_vertices[i][0],
-                    &g_projected_vertices[i][1]);
+    for (b = 0; b < CUBE_COUNT; b++) {
+        ProjectBody(b, g_projected_vertices[b]);
     }
 
-    // If not the first frame, erase the previous frame by drawing black lines
+#if CUBE_RENDER_SOLID
+    if (g_first_frame) {
+        // Nothing on screen yet to erase
+        for (b = 0; b < CUBE_COUNT; b++) {
+            for (i = 0; i < SCREEN_HEIGHT; i++) {
+                g_prev_silhouette_left[b][i] = SCREEN_WIDTH;
+                g_prev_silhouette_right[b][i] = -1;
+            }
+        }
+        g_first_frame = false;
+    }
+    RenderSolidCubes(color);
+#else
+    // If not the first frame, erase the previous frame, restoring any wall
+    // pixels the old edges were drawn over
     if (!g_first_frame) {
-        // Draw black lines over previous edges
-        for (i = 0; i < NUM_EDGES; i++) {
-            int v1 = g_cube_edges[i][0];
-            int v2 = g_cube_edges[i][1];
-
-            drawLine(
-                g_prev_projected_vertices[v1][0], g_prev_projected_vertices[v1][1],
-                g_prev_projected_vertices[v2][0], g_prev_projected_vertices[v2][1],
-                BLACK
-            );
+        for (b = 0; b < CUBE_COUNT; b++) {
+            for (i = 0; i < NUM_EDGES; i++) {
+                int v1 = g_cube_edges[i][0];
+                int v2 = g_cube_edges[i][1];
+
+                WalkLineSpans(
+                    g_prev_projected_vertices[b][v1][0], g_prev_projected_vertices[b][v1][1],
+                    g_prev_projected_vertices[b][v2][0], g_prev_projected_vertices[b][v2][1],
+                    EraseSpan
+                );
+            }
         }
     } else {
         g_first_frame = false; // No longer the first frame
     }
 
     // Draw new edges with the specified color
-    for (i = 0; i < NUM_EDGES; i++) {
-        int v1 = g_cube_edges[i][0];
-        int v2 = g_cube_edges[i][1];
+    for (b = 0; b < CUBE_COUNT; b++) {
+        for (i = 0; i < NUM_EDGES; i++) {
+            int v1 = g_cube_edges[i][0];
+            int v2 = g_cube_edges[i][1];
 
-        drawLine(
-            g_projected_vertices[v1][0], g_projected_vertices[v1][1],
-            g_projected_vertices[v2][0], g_projected_vertices[v2][1],
-            color
-        );
+            drawLine(
+                g_projected_vertices[b][v1][0], g_projected_vertices[b][v1][1],
+                g_projected_vertices[b][v2][0], g_projected_vertices[b][v2][1],
+                color
+            );
+        }
     }
 
     // Copy current vertices to previous vertices for the next frame
-    for (i = 0; i < NUM_VERTICES; i++) {
-        g_prev_projected_vertices[i][0] = g_projected_vertices[i][0];
-        g_prev_projected_vertices[i][1] = g_projected_vertices[i][1];
-    }
+    memcpy(g_prev_projected_vertices, g_projected_vertices, sizeof(g_prev_projected_vertices));
+#endif
 }
 
 //*****************************************************************************
@@ -740,6 +813,10 @@ static void BoardInit(void)
 // Initialize the 3D cube application
 void Cube3D_Initialize(void)
 {
+    const float boxMin[3] = {PHYSICS_MIN_X, PHYSICS_MIN_Y, PHYSICS_MIN_Z};
+    const float boxMax[3] = {PHYSICS_MAX_X, PHYSICS_MAX_Y, PHYSICS_MAX_Z};
+    int i;
+
     // Display banner message
     UART_PRINT("Starting 3D Cube with Accelerometer Control and Physics...\n\r");
 
@@ -755,9 +832,47 @@ void Cube3D_Initialize(void)
     // Open I2C interface for accelerometer
     I2C_IF_Open(I2C_MASTER_MODE_FST);
 
+    // Sample in the background so frames never wait on the bus, and smooth
+    // the stream with the stored calibration (zero offsets if none saved)
+    AccelFilter_LoadCalibration();
+    AccelFilter_Init(&g_accelFilter, CUBE_ACCEL_FILTER, CUBE_ACCEL_FILTER_PARAM);
+    g_accelCursor = 0;
+    g_accelReady = false;
+    AccelSampler_Start(CUBE_ACCEL_RATE_HZ);
+
+    // Pace frames on the game-loop clock, which also times the calibrate
+    // button hold
+    GameLoop_Init(&g_loop, CUBE_PHYSICS_STEP_HZ, CUBE_MAX_STEPS_PER_FRAME);
+    g_calibrateHeld = false;
+
+#if SSD1351_STATS
+    resetDisplayStats();
+    g_statsFrames = 0;
+    g_statsRenderTicks = 0;
+    g_statsStart = GameLoop_Ticks();
+#endif
+
+    // Reciprocal table for the perspective divide
+    Fixed3D_Init();
+
+    // Fill the physics world, all cubes at rest
+    PhysicsWorld_Init(CUBE_SIZE, boxMin, boxMax);
+    for (i = 0; i < CUBE_COUNT; i++) {
+        PhysicsWorld_AddBody(g_start_positions[i][0], g_start_positions[i][1],
+                             g_start_positions[i][2]);
+    }
+
+    // With FRAMEBUFFER_SUPPORT, draw into the shadow framebuffer so
+    // erase/redraw of unchanged pixels never reaches the SPI bus; each frame
+    // flushes the dirty regions. Without it these calls do nothing.
+    Framebuffer_Enable(true);
+
     // Clear the screen
     fillScreen(BLACK);
 
+    // Draw the static wall layer once
+    RenderEnvironment(WALL_COLOR);
+
     // Initialize first frame flag
     g_first_frame = true;
 
@@ -765,34 +880,153 @@ void Cube3D_Initialize(void)
     srand(1234);  // Fixed seed for reproducible results
 }
 
+// Take the average of the newest samples as the flat reading, derive new
+// calibration offsets from it and save them for the next run
+static void CalibrateFlat(void)
+{
+    AccelSample average;
+    int32_t averageQ8[3];
+    int16_t offsets[3];
+
+    if (AccelSampler_GetAverage(&average, ACCEL_SAMPLER_BUFFER_SIZE) == 0) {
+        UART_PRINT("No accelerometer samples to calibrate from\n\r");
+        return;
+    }
+
+    averageQ8[0] = (int32_t)average.x << ACCEL_FILTER_SHIFT;
+    averageQ8[1] = (int32_t)average.y << ACCEL_FILTER_SHIFT;
+    averageQ8[2] = (int32_t)average.z << ACCEL_FILTER_SHIFT;
+    AccelFilter_CalibrateFlat(averageQ8);
+
+    AccelFilter_GetCalibration(offsets);
+    UART_PRINT("Calibrated flat, offsets %d %d %d (Q8 counts)%s\n\r",
+               offsets[0], offsets[1], offsets[2],
+               (AccelFilter_SaveCalibration() == SUCCESS) ? "" : ", not saved");
+
+    // Start the filter over so readings from the old offsets do not linger
+    AccelFilter_Init(&g_accelFilter, CUBE_ACCEL_FILTER, CUBE_ACCEL_FILTER_PARAM);
+
+    // Writing the file took a while; do not simulate that time
+    GameLoop_Resync(&g_loop);
+}
+
+#if SSD1351_STATS
+//*****************************************************************************
+// Every CUBE_STATS_PERIOD_MS print the frame rate, the rate the renderer
+// could reach unpaced, and the display bus traffic per frame from the
+// SSD1351_STATS counters. Build with CUBE_RENDER_SOLID 0 and 1 to compare
+// the two renderers on the same scene.
+//*****************************************************************************
+static void ReportFrameStats(uint32_t renderTicks)
+{
+    uint32_t elapsed = GameLoop_Ticks() - g_statsStart;
+    unsigned long bytes = 0, transactions = 0;
+    unsigned long fps10, maxFps10;
+    int prim;
+
+    g_statsFrames++;
+    g_statsRenderTicks += renderTicks;
+    if (elapsed < CUBE_STATS_PERIOD_MS * (GAME_LOOP_TICKS_PER_SEC / 1000)) {
+        return;
+    }
+
+    for (prim = 0; prim < OLED_PRIM_COUNT; prim++) {
+        bytes += getDisplayStats(prim)->bytes;
+        transactions += getDisplayStats(prim)->transactions;
+    }
+
+    // Tenths of a frame per second
+    fps10 = (unsigned long)((uint64_t)g_statsFrames * 10 * GAME_LOOP_TICKS_PER_SEC / elapsed);
+    maxFps10 = g_statsRenderTicks ? (unsigned long)((uint64_t)g_statsFrames * 10 *
+               GAME_LOOP_TICKS_PER_SEC / g_statsRenderTicks) : 0;
+
+    UART_PRINT("%s: %lu.%lu fps (%lu.%lu unpaced), %lu bytes and %lu CS per frame\n\r",
+               CUBE_RENDER_SOLID ? "solid" : "wireframe", fps10 / 10, fps10 % 10,
+               maxFps10 / 10, maxFps10 % 10, bytes / g_statsFrames, transactions / g_statsFrames);
+
+    resetDisplayStats();
+    g_statsFrames = 0;
+    g_statsRenderTicks = 0;
+    g_statsStart = GameLoop_Ticks();
+}
+#endif
+
+// Calibrate once per press of button 1, after it has been held for
+// CUBE_CALIBRATE_HOLD_MS
+static void CheckCalibrateButton(void)
+{
+    if (GPIOPinRead(BUTTON1_PORT, BUTTON1_PIN) == 0) {
+        g_calibrateHeld = false;
+        return;
+    }
+
+    if (!g_calibrateHeld) {
+        g_calibrateHeld = true;
+        g_calibrateDone = false;
+        g_calibrateStart = GameLoop_Ticks();
+    } else if (!g_calibrateDone &&
+               GameLoop_Ticks() - g_calibrateStart >=
+               CUBE_CALIBRATE_HOLD_MS * (GAME_LOOP_TICKS_PER_SEC / 1000)) {
+        CalibrateFlat();
+        g_calibrateDone = true;
+    }
+}
+
 // Run one frame of the 3D cube application
 // Returns: true to continue running, false to exit
 bool Cube3D_RunFrame(void)
 {
+    int count, steps, i;
+#if SSD1351_STATS
+    uint32_t renderStart;
+#endif
+
     // Check if button 2 is pressed to exit
     if(Cube3D_ShouldExit()) {
         return false;
     }
 
-    if(ReadAccelerometerData() == SUCCESS)
+    CheckCalibrateButton();
+
+    // Run every sample taken since the last frame through the filter
+    count = AccelSampler_ReadNew(&g_accelCursor, g_accelSamples, ACCEL_SAMPLER_BUFFER_SIZE);
+    for (i = 0; i < count; i++) {
+        AccelFilter_Update(&g_accelFilter, &g_accelSamples[i], g_accelFiltered);
+        g_accelReady = true;
+    }
+
+    // Nothing to draw until a physics step is due; return to the caller's
+    // loop instead of spinning
+    steps = GameLoop_StepsDue(&g_loop);
+    if (steps == 0) {
+        return true;
+    }
+
+    if(g_accelReady)
     {
-        // Update physics (accelerometer data is now read inside UpdatePhysics)
-        UpdatePhysics();
+        // Update physics from the filtered reading, one step per due period
+        for (i = 0; i < steps; i++) {
+            UpdatePhysics();
+        }
 
-        // Render the environment walls first (so cube appears on top)
-        RenderEnvironment(WALL_COLOR);
+#if SSD1351_STATS
+        renderStart = GameLoop_Ticks();
+#endif
 
         // Render the cube with the updated position and rotation
         RenderCube(WHITE);
 
-        // Small delay between frames
-        MAP_UtilsDelay(80000);
+        // Push this frame's changed regions to the display
+        Framebuffer_Flush();
+
+#if SSD1351_STATS
+        ReportFrameStats(GameLoop_Ticks() - renderStart);
+#endif
     }
-    else
+    else if (g_loop.steps == (unsigned long)steps)
     {
-        UART_PRINT("Error reading accelerometer!\n\r");
-        // Add delay before retrying
-        MAP_UtilsDelay(800000);
+        // Only said once; the sampler's first reading is a few ms away
+        UART_PRINT("No accelerometer samples yet!\n\r");
     }
 
     return true;
@@ -801,6 +1035,12 @@ bool Cube3D_RunFrame(void)
 // Clean up resources before exiting
 void Cube3D_Cleanup(void)
 {
+    // Hand the I2C bus back to direct reads
+    AccelSampler_Stop();
+
+    // Return to direct drawing for the other applications
+    Framebuffer_Enable(false);
+
     // Clear the screen
     fillScreen(BLACK);
 
@@ -0,0 +1,312 @@
+//*****************************************************************************
+// uDMA Display Transfer Engine
+// See display_dma.h for an overview.
+//
+// GSPI uses uDMA channel 30 (RX) and 31 (TX). Every transmitted byte clocks
+// a byte into the RX register, so the RX channel drains it into a dummy
+// location and its completion (SPI_INT_DMARX) marks the point where the last
+// byte has actually left the shifter.
+//*****************************************************************************
+
+// Standard includes
+#include <stdint.h>
+#include <stdbool.h>
+
+// Driverlib includes
+#include "hw_types.h"
+#include "hw_memmap.h"
+#include "hw_ints.h"
+#include "hw_mcspi.h"
+#include "spi.h"
+#include "udma.h"
+#include "prcm.h"
+#include "rom.h"
+#include "rom_map.h"
+
+#include "Adafruit_SSD1351.h"
+#include "framebuffer.h"
+#include "display_dma.h"
+
+#define SUCCESS                 0
+#define FAILURE                 -1
+
+//*****************************************************************************
+// uDMA control table, 1024-byte aligned as required by the controller
+//*****************************************************************************
+#if defined(ccs)
+#pragma DATA_ALIGN(g_dmaControlTable, 1024)
+static tDMAControlTable g_dmaControlTable[64];
+#else
+static tDMAControlTable g_dmaControlTable[64] __attribute__((aligned(1024)));
+#endif
+
+//*****************************************************************************
+// Global Variables
+//*****************************************************************************
+static bool g_dmaInitialized = false;
+static volatile bool g_displayBusy = false;
+static volatile bool g_transferDone;    // set by the interrupt, finished in thread context
+static DisplayDmaCallback g_doneCallback = 0;
+static void *g_doneArg = 0;
+static unsigned long g_rxDummy;
+
+// Raw transfer state
+static const uint8_t *g_rawData;
+static unsigned long g_rawRemaining;
+
+// Bitmap expansion state. Line n always goes through buffer n & 1. Lines 0
+// and 1 are expanded before the DMA starts, the rest by the interrupt.
+static bool g_bitmapMode;
+static uint8_t g_lineBuf[2][DISPLAY_DMA_LINE_BYTES];
+static int g_lineSending;               // index of the line buffer on the bus
+static int g_linesSent;
+static int g_nextLine;                  // next output line to expand
+static int g_totalLines;
+static unsigned long g_lineLength;      // bytes per output line
+static const uint8_t *g_bitmap;
+static int g_bitmapWidth;
+static int g_bitmapByteWidth;
+static int g_pixelSize;
+static uint8_t g_fgHigh, g_fgLow, g_bgHigh, g_bgLow;
+
+//*****************************************************************************
+// Helpers
+//*****************************************************************************
+
+// Program one basic-mode transfer of len bytes from src on both channels
+static void StartDma(const uint8_t *src, unsigned long len)
+{
+    MAP_uDMAChannelTransferSet(UDMA_CH30_GSPI_RX | UDMA_PRI_SELECT, UDMA_MODE_BASIC,
+                               (void *)(GSPI_BASE + MCSPI_O_RX0), &g_rxDummy, len);
+    MAP_uDMAChannelTransferSet(UDMA_CH31_GSPI_TX | UDMA_PRI_SELECT, UDMA_MODE_BASIC,
+                               (void *)src, (void *)(GSPI_BASE + MCSPI_O_TX0), len);
+
+    // RX first so no received byte is missed once TX starts requesting
+    MAP_uDMAChannelEnable(UDMA_CH30_GSPI_RX);
+    MAP_uDMAChannelEnable(UDMA_CH31_GSPI_TX);
+}
+
+// Expand output line g_nextLine of the bitmap into line buffer buf
+static void ExpandLine(int buf)
+{
+    const uint8_t *src = &g_bitmap[(g_nextLine / g_pixelSize) * g_bitmapByteWidth];
+    uint8_t *dst = g_lineBuf[buf];
+    int i, px;
+
+    for (i = 0; i < g_bitmapWidth; i++) {
+        bool isForeground = src[i >> 3] & (0x80 >> (i & 7));
+        uint8_t high = isForeground ? g_fgHigh : g_bgHigh;
+        uint8_t low = isForeground ? g_fgLow : g_bgLow;
+
+        for (px = 0; px < g_pixelSize; px++) {
+            *dst++ = high;
+            *dst++ = low;
+        }
+    }
+
+    g_nextLine++;
+}
+
+// Thread context, once the interrupt has flagged the transfer as done
+static void FinishTransfer(void)
+{
+    DisplayDmaCallback done = g_doneCallback;
+
+    MAP_SPIDmaDisable(GSPI_BASE, SPI_RX_DMA | SPI_TX_DMA);
+
+    if (g_bitmapMode) {
+        endWindow();
+    }
+
+    g_doneCallback = 0;
+    g_displayBusy = false;
+
+    if (done) {
+        done(g_doneArg);
+    }
+}
+
+//*****************************************************************************
+// GSPI interrupt handler, runs when the RX channel has drained a transfer
+//*****************************************************************************
+static void DisplayDmaIntHandler(void)
+{
+    unsigned long status = MAP_SPIIntStatus(GSPI_BASE, true);
+    MAP_SPIIntClear(GSPI_BASE, SPI_INT_DMARX | SPI_INT_DMATX);
+
+    if (!(status & SPI_INT_DMARX) || !g_displayBusy) {
+        return;
+    }
+
+    if (g_bitmapMode) {
+        if (++g_linesSent == g_totalLines) {
+            g_transferDone = true;
+            return;
+        }
+
+        // The other buffer was filled while this line was on the bus. Ship
+        // it, then refill the one just sent: one line per interrupt, so the
+        // time spent here stays bounded by a single line.
+        g_lineSending ^= 1;
+        StartDma(g_lineBuf[g_lineSending], g_lineLength);
+        if (g_nextLine < g_totalLines) {
+            ExpandLine(g_lineSending ^ 1);
+        }
+    } else {
+        unsigned long chunk;
+
+        if (g_rawRemaining == 0) {
+            g_transferDone = true;
+            return;
+        }
+
+        chunk = (g_rawRemaining > DISPLAY_DMA_MAX_CHUNK) ? DISPLAY_DMA_MAX_CHUNK : g_rawRemaining;
+        StartDma(g_rawData, chunk);
+        g_rawData += chunk;
+        g_rawRemaining -= chunk;
+    }
+}
+
+//*****************************************************************************
+// Public API
+//*****************************************************************************
+void Display_DmaInit(void)
+{
+    MAP_PRCMPeripheralClkEnable(PRCM_UDMA, PRCM_RUN_MODE_CLK);
+    MAP_PRCMPeripheralReset(PRCM_UDMA);
+
+    MAP_uDMAEnable();
+    MAP_uDMAControlBaseSet(g_dmaControlTable);
+
+    MAP_uDMAChannelAssign(UDMA_CH30_GSPI_RX);
+    MAP_uDMAChannelAssign(UDMA_CH31_GSPI_TX);
+    MAP_uDMAChannelAttributeDisable(UDMA_CH30_GSPI_RX, UDMA_ATTR_ALL);
+    MAP_uDMAChannelAttributeDisable(UDMA_CH31_GSPI_TX, UDMA_ATTR_ALL);
+
+    // Byte transfers, one per SPI request. RX always lands on the dummy word.
+    MAP_uDMAChannelControlSet(UDMA_CH30_GSPI_RX | UDMA_PRI_SELECT,
+                              UDMA_SIZE_8 | UDMA_SRC_INC_NONE | UDMA_DST_INC_NONE | UDMA_ARB_1);
+    MAP_uDMAChannelControlSet(UDMA_CH31_GSPI_TX | UDMA_PRI_SELECT,
+                              UDMA_SIZE_8 | UDMA_SRC_INC_8 | UDMA_DST_INC_NONE | UDMA_ARB_1);
+
+    MAP_SPIIntRegister(GSPI_BASE, DisplayDmaIntHandler);
+    MAP_SPIIntEnable(GSPI_BASE, SPI_INT_DMARX);
+
+    g_dmaInitialized = true;
+}
+
+void Display_Service(void)
+{
+    if (!g_displayBusy) {
+        return;
+    }
+
+    // No DMA is in flight once the interrupt has flagged the end
+    if (g_transferDone) {
+        FinishTransfer();
+    }
+}
+
+bool Display_IsBusy(void)
+{
+    Display_Service();
+    return g_displayBusy;
+}
+
+void Display_WaitIdle(void)
+{
+    while (g_displayBusy) {
+        Display_Service();
+    }
+}
+
+int Display_StartTransfer(const void *data, unsigned long length,
+                          DisplayDmaCallback done, void *arg)
+{
+    unsigned long chunk;
+
+    if (!g_dmaInitialized) {
+        return FAILURE;
+    }
+
+    Display_WaitIdle();
+    if (length == 0) {
+        if (done) {
+            done(arg);
+        }
+        return SUCCESS;
+    }
+
+    g_bitmapMode = false;
+    g_transferDone = false;
+    g_doneCallback = done;
+    g_doneArg = arg;
+
+    chunk = (length > DISPLAY_DMA_MAX_CHUNK) ? DISPLAY_DMA_MAX_CHUNK : length;
+    g_rawData = (const uint8_t *)data + chunk;
+    g_rawRemaining = length - chunk;
+
+    g_displayBusy = true;
+    MAP_SPIDmaEnable(GSPI_BASE, SPI_RX_DMA | SPI_TX_DMA);
+    StartDma((const uint8_t *)data, chunk);
+
+    return SUCCESS;
+}
+
+void Display_DrawBitmapAsync(int x, int y, const uint8_t *bitmap, int width, int height,
+                             uint16_t color, uint16_t bg_color, int pixelSize,
+                             DisplayDmaCallback done, void *arg)
+{
+    int scaledWidth = width * pixelSize;
+    int scaledHeight = height * pixelSize;
+
+    Display_WaitIdle();
+
+    if (scaledWidth <= 0 || scaledHeight <= 0) {
+        if (done) {
+            done(arg);
+        }
+        return;
+    }
+
+    if (!g_dmaInitialized || Framebuffer_IsEnabled() || getScrollOffset() != 0 || bg_color == 1 ||
+        pixelSize < 1 || x < 0 || y < 0 || scaledWidth > DISPLAY_DMA_LINE_PIXELS ||
+        x + scaledWidth > SSD1351WIDTH || y + scaledHeight > SSD1351HEIGHT) {
+        fastDrawBitmap(x, y, bitmap, width, height, color, bg_color, pixelSize);
+        if (done) {
+            done(arg);
+        }
+        return;
+    }
+
+    g_bitmapMode = true;
+    g_doneCallback = done;
+    g_doneArg = arg;
+    g_bitmap = bitmap;
+    g_bitmapWidth = width;
+    g_bitmapByteWidth = (width + 7) / 8;
+    g_pixelSize = pixelSize;
+    g_fgHigh = color >> 8;
+    g_fgLow = color & 0xFF;
+    g_bgHigh = bg_color >> 8;
+    g_bgLow = bg_color & 0xFF;
+    g_totalLines = scaledHeight;
+    g_lineLength = scaledWidth * 2;
+    g_nextLine = 0;
+    g_linesSent = 0;
+    g_lineSending = 0;
+    g_transferDone = false;
+
+    // Fill both buffers up front so the interrupt always has the next line
+    // ready and only ever expands the one after it
+    ExpandLine(0);
+    if (g_totalLines > 1) {
+        ExpandLine(1);
+    }
+
+    beginWindow(x, y, scaledWidth, scaledHeight);
+
+    g_displayBusy = true;
+    MAP_SPIDmaEnable(GSPI_BASE, SPI_RX_DMA | SPI_TX_DMA);
+    StartDma(g_lineBuf[0], g_lineLength);
+}
@@ -0,0 +1,78 @@
+//*****************************************************************************
+// uDMA Display Transfer Engine
+// Streams pixel data to the SSD1351 over GSPI with the uDMA controller so the
+// CPU is free while a frame is on the bus. 1bpp bitmaps are expanded into two
+// RGB565 line buffers in ping-pong fashion: the first two lines are expanded
+// before the DMA starts, and each line-completion interrupt starts the next
+// line and expands one more into the buffer it just freed, so a frame runs
+// to the end without the caller's help. The window is closed and the done
+// callback run in thread context, by the next call that services the engine.
+//*****************************************************************************
+
+#ifndef DISPLAY_DMA_H_
+#define DISPLAY_DMA_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Longest line the engine will expand, in pixels
+#define DISPLAY_DMA_LINE_PIXELS     128
+#define DISPLAY_DMA_LINE_BYTES      (DISPLAY_DMA_LINE_PIXELS * 2)
+
+// uDMA transfers are limited to 1024 items, raw transfers are split into chunks
+#define DISPLAY_DMA_MAX_CHUNK       1024
+
+// Called in thread context, from Display_Service() or a call that waits on
+// the engine, once a transfer has finished
+typedef void (*DisplayDmaCallback)(void *arg);
+
+//*****************************************************************************
+// Set up the uDMA controller and the GSPI channels. Call after the SPI
+// interface has been configured and enabled. Until this has run every draw
+// call below falls back to the blocking driver.
+//*****************************************************************************
+void Display_DmaInit(void);
+
+//*****************************************************************************
+// Draw a 1bpp bitmap in the background. Foreground bits become color and
+// background bits bg_color, each scaled by pixelSize. The bitmap must stay
+// valid until the transfer completes: call Display_WaitIdle() before reusing
+// the buffer (e.g. before the next get_X_frame()).
+// Empty bitmaps only run the callback.
+// Transparent backgrounds (bg_color == 1), bitmaps that do not fit on screen
+// and frames drawn while the shadow framebuffer is enabled or the display is
+// scrolled are drawn synchronously instead.
+//*****************************************************************************
+void Display_DrawBitmapAsync(int x, int y, const uint8_t *bitmap, int width, int height,
+                             uint16_t color, uint16_t bg_color, int pixelSize,
+                             DisplayDmaCallback done, void *arg);
+
+//*****************************************************************************
+// Send length bytes of pixel data into a window the caller has opened with
+// beginWindow(). The caller ends the window after Display_WaitIdle().
+// Waits for any earlier transfer first. Returns 0, or -1 if the engine has
+// not been initialized.
+//*****************************************************************************
+int Display_StartTransfer(const void *data, unsigned long length,
+                          DisplayDmaCallback done, void *arg);
+
+//*****************************************************************************
+// Finish a transfer the interrupt has flagged as done: close the window and
+// run the done callback. Only needed to get the callback run early; the calls
+// below and every blocking draw service the engine anyway.
+//*****************************************************************************
+void Display_Service(void);
+
+//*****************************************************************************
+// Returns true while a transfer is in flight. Services the engine first.
+//*****************************************************************************
+bool Display_IsBusy(void);
+
+//*****************************************************************************
+// Block until the engine is idle, servicing it meanwhile. The blocking
+// drawing primitives call this before touching the bus, so mixing them with
+// async transfers is safe.
+//*****************************************************************************
+void Display_WaitIdle(void);
+
+#endif /* DISPLAY_DMA_H_ */
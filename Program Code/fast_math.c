@@ -0,0 +1,260 @@
+//*****************************************************************************
+// Fast Math
+// See fast_math.h for an overview and the error bounds.
+//*****************************************************************************
+
+// Standard includes
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "fast_math.h"
+
+#if FAST_MATH_BENCHMARK
+#include <math.h>
+#include "systick.h"
+#include "uart_if.h"
+#endif
+
+#define SIN_TABLE_SIZE          (1 << FAST_MATH_SIN_TABLE_BITS)
+#define SIN_QUARTER             (SIN_TABLE_SIZE / 4)
+#define SIN_INDEX_MASK          (SIN_TABLE_SIZE - 1)
+
+// Table steps per radian
+#define SIN_INDEX_SCALE         ((float)SIN_TABLE_SIZE / FAST_MATH_TWO_PI)
+
+//*****************************************************************************
+// Global Variables
+//*****************************************************************************
+static float g_sinTable[SIN_QUARTER + 1];   // sin over [0, pi/2] inclusive
+static bool g_sinTableReady = false;
+
+//*****************************************************************************
+// Helpers
+//*****************************************************************************
+
+// sin(index * 2pi / N) for any index in [0, N]
+static float SinAt(int index)
+{
+    int quadrant = (index >> (FAST_MATH_SIN_TABLE_BITS - 2)) & 3;
+    int offset = index & (SIN_QUARTER - 1);
+
+    switch (quadrant) {
+    case 0:  return g_sinTable[offset];
+    case 1:  return g_sinTable[SIN_QUARTER - offset];
+    case 2:  return -g_sinTable[offset];
+    default: return -g_sinTable[SIN_QUARTER - offset];
+    }
+}
+
+// Interpolated lookup, phase given in table steps
+static float SinSteps(float steps)
+{
+    int index = (int)steps;
+    float frac;
+    float s0, s1;
+
+    if (steps < (float)index) {
+        index--;    // floor for negative angles
+    }
+    frac = steps - (float)index;
+    index &= SIN_INDEX_MASK;
+
+    s0 = SinAt(index);
+    s1 = SinAt(index + 1);
+    return s0 + (s1 - s0) * frac;
+}
+
+//*****************************************************************************
+// Public API
+//*****************************************************************************
+
+// The quarter wave comes from the recurrence sin((k+1)h) = 2cos(h)sin(kh) -
+// sin((k-1)h), seeded from Taylor series, so no libm is needed. Run in
+// double, the drift over 257 steps stays far below float resolution.
+void FastMath_Init(void)
+{
+    double h, h2, twoCos, prev, cur, next;
+    int k;
+
+    if (g_sinTableReady) {
+        return;
+    }
+
+    h = 6.283185307179586 / SIN_TABLE_SIZE;
+    h2 = h * h;
+    twoCos = 2.0 * (1.0 - h2 / 2.0 + h2 * h2 / 24.0 - h2 * h2 * h2 / 720.0);
+
+    prev = 0.0;
+    cur = h * (1.0 - h2 / 6.0 + h2 * h2 / 120.0 - h2 * h2 * h2 / 5040.0);
+    g_sinTable[0] = 0.0f;
+    g_sinTable[1] = (float)cur;
+
+    for (k = 2; k <= SIN_QUARTER; k++) {
+        next = twoCos * cur - prev;
+        prev = cur;
+        cur = next;
+        g_sinTable[k] = (float)cur;
+    }
+    g_sinTable[SIN_QUARTER] = 1.0f;
+
+    g_sinTableReady = true;
+}
+
+float FastMath_Sin(float angle)
+{
+    if (!g_sinTableReady) {
+        FastMath_Init();
+    }
+    return SinSteps(angle * SIN_INDEX_SCALE);
+}
+
+float FastMath_Cos(float angle)
+{
+    if (!g_sinTableReady) {
+        FastMath_Init();
+    }
+    return SinSteps(angle * SIN_INDEX_SCALE + (float)SIN_QUARTER);
+}
+
+void FastMath_SinCos(float angle, float *s, float *c)
+{
+    float steps;
+
+    if (!g_sinTableReady) {
+        FastMath_Init();
+    }
+    steps = angle * SIN_INDEX_SCALE;
+    *s = SinSteps(steps);
+    *c = SinSteps(steps + (float)SIN_QUARTER);
+}
+
+float FastMath_InvSqrt(float x)
+{
+    union {
+        float f;
+        uint32_t i;
+    } u;
+    float half = 0.5f * x;
+    int n;
+
+    if (x <= 0.0f) {
+        return 0.0f;
+    }
+
+    // Initial guess from the exponent bits, then Newton steps
+    u.f = x;
+    u.i = 0x5F3759DF - (u.i >> 1);
+    for (n = 0; n < FAST_MATH_INVSQRT_ITERATIONS; n++) {
+        u.f = u.f * (1.5f - half * u.f * u.f);
+    }
+    return u.f;
+}
+
+float FastMath_Sqrt(float x)
+{
+    return x * FastMath_InvSqrt(x);
+}
+
+// Abramowitz & Stegun 4.4.45: acos(x) = sqrt(1 - x) * P(x) on [0, 1]
+float FastMath_Acos(float x)
+{
+    bool negative = (x < 0.0f);
+    float result;
+
+    if (negative) {
+        x = -x;
+    }
+    if (x > 1.0f) {
+        x = 1.0f;
+    }
+
+    result = -0.0187293f;
+    result = result * x + 0.0742610f;
+    result = result * x - 0.2121144f;
+    result = result * x + 1.5707288f;
+    result *= FastMath_Sqrt(1.0f - x);
+
+    return negative ? FAST_MATH_PI - result : result;
+}
+
+// Odd minimax polynomial for atan on [0, 1], folded out to all octants
+float FastMath_Atan2(float y, float x)
+{
+    float ax = (x < 0.0f) ? -x : x;
+    float ay = (y < 0.0f) ? -y : y;
+    float z, z2, result;
+
+    if (ax == 0.0f && ay == 0.0f) {
+        return 0.0f;
+    }
+
+    z = (ax > ay) ? ay / ax : ax / ay;
+    z2 = z * z;
+    result = -0.0117212f;
+    result = result * z2 + 0.05265332f;
+    result = result * z2 - 0.11643287f;
+    result = result * z2 + 0.19354346f;
+    result = result * z2 - 0.33262347f;
+    result = result * z2 + 0.99997726f;
+    result *= z;
+
+    if (ay > ax) {
+        result = FAST_MATH_HALF_PI - result;
+    }
+    if (x < 0.0f) {
+        result = FAST_MATH_PI - result;
+    }
+    return (y < 0.0f) ? -result : result;
+}
+
+#if FAST_MATH_BENCHMARK
+//*****************************************************************************
+// Benchmark
+// Each routine runs over the same spread of inputs; the volatile sink keeps
+// the calls from being optimized away. SysTick counts down at 80MHz.
+//*****************************************************************************
+#define BENCH_CALLS             256
+
+static volatile float g_benchSink;
+
+static unsigned long BenchTicks(unsigned long start)
+{
+    return ((start - SysTickValueGet()) & 0xFFFFFF) / BENCH_CALLS;
+}
+
+void FastMath_Benchmark(void)
+{
+    unsigned long start;
+    int i;
+
+    FastMath_Init();
+
+    SysTickDisable();
+    SysTickIntDisable();
+    SysTickPeriodSet(0xFFFFFF);
+    SysTickEnable();
+
+#define BENCH(label, expr)                                          \
+    start = SysTickValueGet();                                      \
+    for (i = 0; i < BENCH_CALLS; i++) {                             \
+        float v = (float)(i - BENCH_CALLS / 2) * (1.0f / 64.0f);    \
+        g_benchSink = (expr);                                       \
+    }                                                               \
+    Report("%-16s %lu cycles\n\r", label, BenchTicks(start));
+
+    BENCH("sinf", sinf(v));
+    BENCH("FastMath_Sin", FastMath_Sin(v));
+    BENCH("cosf", cosf(v));
+    BENCH("FastMath_Cos", FastMath_Cos(v));
+    BENCH("1/sqrtf", 1.0f / sqrtf(v + 3.0f));
+    BENCH("FastMath_InvSqrt", FastMath_InvSqrt(v + 3.0f));
+    BENCH("sqrtf", sqrtf(v + 3.0f));
+    BENCH("FastMath_Sqrt", FastMath_Sqrt(v + 3.0f));
+    BENCH("acosf", acosf(v * 0.25f));
+    BENCH("FastMath_Acos", FastMath_Acos(v * 0.25f));
+    BENCH("atan2f", atan2f(v, 0.7f));
+    BENCH("FastMath_Atan2", FastMath_Atan2(v, 0.7f));
+
+#undef BENCH
+}
+#endif // FAST_MATH_BENCHMARK
@@ -0,0 +1,81 @@
+//*****************************************************************************
+// Fast Math
+// Table and polynomial replacements for the soft-float libm routines the
+// apps call every frame. The Cortex-M4 here has no FPU, so a libm sinf()
+// costs a few thousand cycles; these cost a table lookup or a handful of
+// multiplies.
+//
+// Error bounds (absolute unless noted, measured against double precision):
+//   FastMath_Sin/Cos    2^FAST_MATH_SIN_TABLE_BITS entries per period,
+//                       linear interpolation, about (2*pi/N)^2 / 8 for
+//                       |angle| <= 2*pi:
+//                         8 bits: 7.6e-5   10 bits: 4.8e-6   12 bits: 8.6e-7
+//                       Larger angles lose float precision in the phase,
+//                       about 8e-6 at |angle| = 60.
+//   FastMath_InvSqrt    relative error 1.8e-3 after one Newton step,
+//                       4.7e-6 after two (FAST_MATH_INVSQRT_ITERATIONS)
+//   FastMath_Sqrt       same relative error as FastMath_InvSqrt
+//   FastMath_Acos       7.5e-5 rad with two Newton steps, 2.7e-3 with one
+//   FastMath_Atan2      2.0e-6 rad
+//*****************************************************************************
+
+#ifndef FAST_MATH_H_
+#define FAST_MATH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Sine table size as a power of two per full period (8 to 12). Only a
+// quarter wave is stored: 10 bits costs 257 floats of RAM.
+#ifndef FAST_MATH_SIN_TABLE_BITS
+#define FAST_MATH_SIN_TABLE_BITS    10
+#endif
+
+// Newton-Raphson refinements after the initial inverse square root guess
+#ifndef FAST_MATH_INVSQRT_ITERATIONS
+#define FAST_MATH_INVSQRT_ITERATIONS 2
+#endif
+
+// Set to 1 to build FastMath_Benchmark(), which links libm for comparison
+#ifndef FAST_MATH_BENCHMARK
+#define FAST_MATH_BENCHMARK         0
+#endif
+
+#define FAST_MATH_PI                3.14159265f
+#define FAST_MATH_TWO_PI            6.28318531f
+#define FAST_MATH_HALF_PI           1.57079633f
+
+//*****************************************************************************
+// Build the sine table. The trig functions do this on first use, calling it
+// at startup just keeps that cost out of the first frame.
+//*****************************************************************************
+void FastMath_Init(void);
+
+//*****************************************************************************
+// Trigonometry, angles in radians (any range)
+//*****************************************************************************
+float FastMath_Sin(float angle);
+float FastMath_Cos(float angle);
+void FastMath_SinCos(float angle, float *s, float *c);
+
+//*****************************************************************************
+// 1/sqrt(x) and sqrt(x). Both return 0 for x <= 0.
+//*****************************************************************************
+float FastMath_InvSqrt(float x);
+float FastMath_Sqrt(float x);
+
+//*****************************************************************************
+// Inverse trigonometry. FastMath_Acos clamps x to [-1, 1].
+//*****************************************************************************
+float FastMath_Acos(float x);
+float FastMath_Atan2(float y, float x);
+
+#if FAST_MATH_BENCHMARK
+//*****************************************************************************
+// Time each routine against its libm counterpart with SysTick and print the
+// cycles per call over UART
+//*****************************************************************************
+void FastMath_Benchmark(void);
+#endif
+
+#endif /* FAST_MATH_H_ */
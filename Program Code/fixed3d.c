@@ -0,0 +1,233 @@
+//*****************************************************************************
+// Fixed-Point 3D Transform Pipeline
+// See fixed3d.h for an overview. Products are formed in 64 bits (a single
+// SMULL/SMLAL on the Cortex-M4) and rounded back to Q16.16.
+//*****************************************************************************
+
+// Standard includes
+#include <stdint.h>
+#include <stdbool.h>
+#include "fixed3d.h"
+#include "fast_math.h"
+
+// Reciprocals are kept in Q8.24 so 1/1 still fits and 1/256 keeps 16 bits
+#define RECIP_SHIFT             24
+
+// Depths closer to zero than this project without perspective (0.001 units)
+#define DEPTH_EPSILON           66
+
+//*****************************************************************************
+// Global Variables
+//*****************************************************************************
+static uint32_t g_recipTable[FIXED3D_RECIP_MAX + 1];
+static bool g_recipReady = false;
+
+//*****************************************************************************
+// Helpers
+//*****************************************************************************
+static fixed_t FixedMul(fixed_t a, fixed_t b)
+{
+    return (fixed_t)(((int64_t)a * b + (1 << (FIXED3D_SHIFT - 1))) >> FIXED3D_SHIFT);
+}
+
+// Shift right rounding toward zero, the way a float to int cast does
+static int TruncShift(int64_t v, int shift)
+{
+    return (v < 0) ? -(int)((-v) >> shift) : (int)(v >> shift);
+}
+
+// Scale a Q16.16 coordinate by focal / depth and truncate to whole pixels
+static int PerspectiveOffset(fixed_t v, int focal, fixed_t depth)
+{
+    if (g_recipReady && depth >= FIXED3D_ONE && depth < FIXED3D_FROM_INT(FIXED3D_RECIP_MAX)) {
+        int index = depth >> FIXED3D_SHIFT;
+        uint32_t frac = depth & (FIXED3D_ONE - 1);
+        uint32_t r0 = g_recipTable[index];
+        uint32_t r1 = g_recipTable[index + 1];
+
+        // Linear interpolation between neighbouring integer depths
+        int64_t recip = r0 - (int64_t)(((uint64_t)(r0 - r1) * frac) >> FIXED3D_SHIFT);
+
+        return TruncShift((int64_t)v * focal * recip, FIXED3D_SHIFT + RECIP_SHIFT);
+    }
+
+    // Outside the table: a real (truncating) division
+    return (int)(((int64_t)v * focal) / depth);
+}
+
+//*****************************************************************************
+// Public API
+//*****************************************************************************
+void Fixed3D_Init(void)
+{
+    int d;
+
+    if (g_recipReady) {
+        return;
+    }
+
+    g_recipTable[0] = 0;    // never used, depths below 1 take the division path
+    for (d = 1; d <= FIXED3D_RECIP_MAX; d++) {
+        g_recipTable[d] = ((uint32_t)1 << RECIP_SHIFT) / d;
+    }
+    g_recipReady = true;
+}
+
+void Fixed3D_Identity(Fixed3D_Matrix *out)
+{
+    int i, j;
+
+    for (i = 0; i < 3; i++) {
+        for (j = 0; j < 3; j++) {
+            out->m[i][j] = (i == j) ? FIXED3D_ONE : 0;
+        }
+        out->t[i] = 0;
+    }
+}
+
+// Closed form of Rz * Ry * Rx, so the trig runs once per frame
+void Fixed3D_FromEuler(Fixed3D_Matrix *out, float angleX, float angleY, float angleZ)
+{
+    float sx, cx, sy, cy, sz, cz;
+
+    FastMath_SinCos(angleX, &sx, &cx);
+    FastMath_SinCos(angleY, &sy, &cy);
+    FastMath_SinCos(angleZ, &sz, &cz);
+
+    out->m[0][0] = FIXED3D_FROM_FLOAT(cz * cy);
+    out->m[0][1] = FIXED3D_FROM_FLOAT(cz * sy * sx - sz * cx);
+    out->m[0][2] = FIXED3D_FROM_FLOAT(cz * sy * cx + sz * sx);
+
+    out->m[1][0] = FIXED3D_FROM_FLOAT(sz * cy);
+    out->m[1][1] = FIXED3D_FROM_FLOAT(sz * sy * sx + cz * cx);
+    out->m[1][2] = FIXED3D_FROM_FLOAT(sz * sy * cx - cz * sx);
+
+    out->m[2][0] = FIXED3D_FROM_FLOAT(-sy);
+    out->m[2][1] = FIXED3D_FROM_FLOAT(cy * sx);
+    out->m[2][2] = FIXED3D_FROM_FLOAT(cy * cx);
+
+    out->t[0] = 0;
+    out->t[1] = 0;
+    out->t[2] = 0;
+}
+
+void Fixed3D_FromQuaternion(Fixed3D_Matrix *out, const Fixed3D_Quat *q)
+{
+    float xx = q->x * q->x, yy = q->y * q->y, zz = q->z * q->z;
+    float xy = q->x * q->y, xz = q->x * q->z, yz = q->y * q->z;
+    float wx = q->w * q->x, wy = q->w * q->y, wz = q->w * q->z;
+
+    out->m[0][0] = FIXED3D_FROM_FLOAT(1.0f - 2.0f * (yy + zz));
+    out->m[0][1] = FIXED3D_FROM_FLOAT(2.0f * (xy - wz));
+    out->m[0][2] = FIXED3D_FROM_FLOAT(2.0f * (xz + wy));
+
+    out->m[1][0] = FIXED3D_FROM_FLOAT(2.0f * (xy + wz));
+    out->m[1][1] = FIXED3D_FROM_FLOAT(1.0f - 2.0f * (xx + zz));
+    out->m[1][2] = FIXED3D_FROM_FLOAT(2.0f * (yz - wx));
+
+    out->m[2][0] = FIXED3D_FROM_FLOAT(2.0f * (xz - wy));
+    out->m[2][1] = FIXED3D_FROM_FLOAT(2.0f * (yz + wx));
+    out->m[2][2] = FIXED3D_FROM_FLOAT(1.0f - 2.0f * (xx + yy));
+
+    out->t[0] = 0;
+    out->t[1] = 0;
+    out->t[2] = 0;
+}
+
+void Fixed3D_QuatIdentity(Fixed3D_Quat *q)
+{
+    q->w = 1.0f;
+    q->x = 0.0f;
+    q->y = 0.0f;
+    q->z = 0.0f;
+}
+
+// q += dt/2 * (0, w) * q
+void Fixed3D_QuatIntegrate(Fixed3D_Quat *q, float wx, float wy, float wz, float dt)
+{
+    float h = 0.5f * dt;
+    Fixed3D_Quat r;
+    float inv;
+
+    r.w = q->w + h * (-wx * q->x - wy * q->y - wz * q->z);
+    r.x = q->x + h * ( wx * q->w + wy * q->z - wz * q->y);
+    r.y = q->y + h * ( wy * q->w + wz * q->x - wx * q->z);
+    r.z = q->z + h * ( wz * q->w + wx * q->y - wy * q->x);
+
+    inv = FastMath_InvSqrt(r.w * r.w + r.x * r.x + r.y * r.y + r.z * r.z);
+    if (inv == 0.0f) {
+        Fixed3D_QuatIdentity(q);
+        return;
+    }
+
+    q->w = r.w * inv;
+    q->x = r.x * inv;
+    q->y = r.y * inv;
+    q->z = r.z * inv;
+}
+
+void Fixed3D_Multiply(Fixed3D_Matrix *out, const Fixed3D_Matrix *a, const Fixed3D_Matrix *b)
+{
+    Fixed3D_Matrix r;
+    int i, j;
+
+    for (i = 0; i < 3; i++) {
+        for (j = 0; j < 3; j++) {
+            r.m[i][j] = (fixed_t)(((int64_t)a->m[i][0] * b->m[0][j] +
+                                   (int64_t)a->m[i][1] * b->m[1][j] +
+                                   (int64_t)a->m[i][2] * b->m[2][j] +
+                                   (1 << (FIXED3D_SHIFT - 1))) >> FIXED3D_SHIFT);
+        }
+        r.t[i] = FixedMul(a->m[i][0], b->t[0]) +
+                 FixedMul(a->m[i][1], b->t[1]) +
+                 FixedMul(a->m[i][2], b->t[2]) + a->t[i];
+    }
+
+    *out = r;
+}
+
+void Fixed3D_TransformVectors(const Fixed3D_Matrix *mat, fixed_t (*in)[3],
+                              fixed_t (*out)[3], int count)
+{
+    int i, k;
+
+    for (i = 0; i < count; i++) {
+        fixed_t x = in[i][0];
+        fixed_t y = in[i][1];
+        fixed_t z = in[i][2];
+
+        for (k = 0; k < 3; k++) {
+            out[i][k] = (fixed_t)(((int64_t)mat->m[k][0] * x +
+                                   (int64_t)mat->m[k][1] * y +
+                                   (int64_t)mat->m[k][2] * z +
+                                   (1 << (FIXED3D_SHIFT - 1))) >> FIXED3D_SHIFT);
+        }
+    }
+}
+
+void Fixed3D_TransformPoints(const Fixed3D_Matrix *mat, fixed_t (*in)[3],
+                             fixed_t (*out)[3], int count)
+{
+    int i;
+
+    Fixed3D_TransformVectors(mat, in, out, count);
+    for (i = 0; i < count; i++) {
+        out[i][0] += mat->t[0];
+        out[i][1] += mat->t[1];
+        out[i][2] += mat->t[2];
+    }
+}
+
+void Fixed3D_Project(fixed_t x, fixed_t y, fixed_t z, int focal, int zOffset,
+                     int centerX, int centerY, int *px, int *py)
+{
+    fixed_t depth = z + FIXED3D_FROM_INT(zOffset);
+
+    if (depth > DEPTH_EPSILON || depth < -DEPTH_EPSILON) {
+        *px = centerX + PerspectiveOffset(x, focal, depth);
+        *py = centerY - PerspectiveOffset(y, focal, depth);  // Y is inverted in screen space
+    } else {
+        *px = centerX + TruncShift(x, FIXED3D_SHIFT);
+        *py = centerY - TruncShift(y, FIXED3D_SHIFT);
+    }
+}
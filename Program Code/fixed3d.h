@@ -0,0 +1,91 @@
+//*****************************************************************************
+// Fixed-Point 3D Transform Pipeline
+// Q16.16 matrices and vertices for the wireframe apps. The orientation is
+// turned into one 3x3 matrix (plus translation) per frame, so the per-vertex
+// work is nine integer multiplies instead of a dozen sinf/cosf calls on a
+// core without an FPU. The perspective divide goes through a reciprocal
+// table indexed by integer depth and interpolated on the fractional part.
+//*****************************************************************************
+
+#ifndef FIXED3D_H_
+#define FIXED3D_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef int32_t fixed_t;
+
+#define FIXED3D_SHIFT           16
+#define FIXED3D_ONE             ((fixed_t)1 << FIXED3D_SHIFT)
+
+#define FIXED3D_FROM_INT(i)     ((fixed_t)(i) * FIXED3D_ONE)
+#define FIXED3D_FROM_FLOAT(f)   ((fixed_t)((f) * 65536.0f + (((f) < 0) ? -0.5f : 0.5f)))
+#define FIXED3D_TO_FLOAT(q)     ((float)(q) * (1.0f / 65536.0f))
+
+// Depths (z + camera offset) covered by the reciprocal table, in whole units.
+// Points outside the range fall back to a real division.
+#define FIXED3D_RECIP_MAX       256
+
+//*****************************************************************************
+// Affine transform: out = m * in + t
+//*****************************************************************************
+typedef struct {
+    fixed_t m[3][3];
+    fixed_t t[3];
+} Fixed3D_Matrix;
+
+//*****************************************************************************
+// Orientation quaternion (unit length, w is the scalar part)
+//*****************************************************************************
+typedef struct {
+    float w;
+    float x;
+    float y;
+    float z;
+} Fixed3D_Quat;
+
+//*****************************************************************************
+// Fill the reciprocal table. Safe to call more than once.
+//*****************************************************************************
+void Fixed3D_Init(void);
+
+//*****************************************************************************
+// Matrix construction
+// Fixed3D_FromEuler rotates about X, then Y, then Z, matching the order the
+// cube has always used. Fixed3D_Multiply computes out = a * b (b is applied
+// first); out may alias either input.
+//*****************************************************************************
+void Fixed3D_Identity(Fixed3D_Matrix *out);
+void Fixed3D_FromEuler(Fixed3D_Matrix *out, float angleX, float angleY, float angleZ);
+void Fixed3D_Multiply(Fixed3D_Matrix *out, const Fixed3D_Matrix *a, const Fixed3D_Matrix *b);
+void Fixed3D_FromQuaternion(Fixed3D_Matrix *out, const Fixed3D_Quat *q);
+
+//*****************************************************************************
+// Quaternion integration
+// Advance q by the world-frame angular velocity (wx, wy, wz) in radians per
+// unit time over dt, then renormalize so rounding never shears the matrix.
+//*****************************************************************************
+void Fixed3D_QuatIdentity(Fixed3D_Quat *q);
+void Fixed3D_QuatIntegrate(Fixed3D_Quat *q, float wx, float wy, float wz, float dt);
+
+//*****************************************************************************
+// Transform count vertices from in to out (arrays of x, y, z). Points get the
+// translation, vectors (normals, directions) do not. in and out may be the
+// same array.
+//*****************************************************************************
+void Fixed3D_TransformPoints(const Fixed3D_Matrix *mat, fixed_t (*in)[3],
+                             fixed_t (*out)[3], int count);
+void Fixed3D_TransformVectors(const Fixed3D_Matrix *mat, fixed_t (*in)[3],
+                              fixed_t (*out)[3], int count);
+
+//*****************************************************************************
+// Perspective projection around the screen center:
+//   px = centerX + x * focal / (z + zOffset)
+//   py = centerY - y * focal / (z + zOffset)
+// Offsets are truncated toward zero like the (int) casts of the float code.
+// A depth of (nearly) zero projects without perspective.
+//*****************************************************************************
+void Fixed3D_Project(fixed_t x, fixed_t y, fixed_t z, int focal, int zOffset,
+                     int centerX, int centerY, int *px, int *py);
+
+#endif /* FIXED3D_H_ */
@@ -0,0 +1,330 @@
+//*****************************************************************************
+// Shadow Framebuffer for the SSD1351 OLED
+// See framebuffer.h for an overview. Pixels are stored as native RGB565 words
+// and streamed to the panel through the Adafruit_OLED pixel window API.
+//*****************************************************************************
+
+// Standard includes
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "Adafruit_SSD1351.h"
+#include "framebuffer.h"
+
+#if FRAMEBUFFER_SUPPORT
+
+//*****************************************************************************
+// Dirty rectangle, inclusive corners
+//*****************************************************************************
+typedef struct {
+    int16_t x0;
+    int16_t y0;
+    int16_t x1;
+    int16_t y1;
+} DirtyRect;
+
+//*****************************************************************************
+// Global Variables
+//*****************************************************************************
+static uint16_t g_framebuffer[FRAMEBUFFER_WIDTH * FRAMEBUFFER_HEIGHT];
+static DirtyRect g_dirtyRects[FRAMEBUFFER_MAX_DIRTY];
+static int g_dirtyCount = 0;
+static bool g_framebufferEnabled = false;
+
+//*****************************************************************************
+// Helpers
+//*****************************************************************************
+static int RectArea(const DirtyRect *r)
+{
+    return (r->x1 - r->x0 + 1) * (r->y1 - r->y0 + 1);
+}
+
+static void RectUnion(const DirtyRect *a, const DirtyRect *b, DirtyRect *out)
+{
+    out->x0 = (a->x0 < b->x0) ? a->x0 : b->x0;
+    out->y0 = (a->y0 < b->y0) ? a->y0 : b->y0;
+    out->x1 = (a->x1 > b->x1) ? a->x1 : b->x1;
+    out->y1 = (a->y1 > b->y1) ? a->y1 : b->y1;
+}
+
+// Pixels the union of a and b would send that neither a nor b needs
+static int MergeWaste(const DirtyRect *a, const DirtyRect *b)
+{
+    DirtyRect u;
+    RectUnion(a, b, &u);
+    return RectArea(&u) - RectArea(a) - RectArea(b);
+}
+
+static void RemoveRect(int index)
+{
+    g_dirtyCount--;
+    if (index != g_dirtyCount) {
+        g_dirtyRects[index] = g_dirtyRects[g_dirtyCount];
+    }
+}
+
+// Merge the cheapest pair of rectangles to free one slot
+static void MergeCheapestPair(void)
+{
+    int i, j;
+    int bestI = 0;
+    int bestJ = 1;
+    int bestWaste = 0x7FFFFFFF;
+
+    for (i = 0; i < g_dirtyCount; i++) {
+        for (j = i + 1; j < g_dirtyCount; j++) {
+            int waste = MergeWaste(&g_dirtyRects[i], &g_dirtyRects[j]);
+            if (waste < bestWaste) {
+                bestWaste = waste;
+                bestI = i;
+                bestJ = j;
+            }
+        }
+    }
+
+    RectUnion(&g_dirtyRects[bestI], &g_dirtyRects[bestJ], &g_dirtyRects[bestI]);
+    RemoveRect(bestJ);
+}
+
+// Add an already clipped rectangle to the dirty list
+static void AddDirtyRect(int x0, int y0, int x1, int y1)
+{
+    DirtyRect r;
+    int i;
+    bool merged;
+
+    r.x0 = x0;
+    r.y0 = y0;
+    r.x1 = x1;
+    r.y1 = y1;
+
+    // Fold r into any rectangle that makes a cheap union. A merge grows r, so
+    // rescan until nothing else can be absorbed.
+    do {
+        merged = false;
+        for (i = 0; i < g_dirtyCount; i++) {
+            if (MergeWaste(&g_dirtyRects[i], &r) <= FRAMEBUFFER_MERGE_SLACK) {
+                RectUnion(&g_dirtyRects[i], &r, &r);
+                RemoveRect(i);
+                merged = true;
+                break;
+            }
+        }
+    } while (merged);
+
+    if (g_dirtyCount == FRAMEBUFFER_MAX_DIRTY) {
+        MergeCheapestPair();
+    }
+    g_dirtyRects[g_dirtyCount++] = r;
+}
+
+static bool IsPixelDirty(int x, int y)
+{
+    int i;
+    for (i = 0; i < g_dirtyCount; i++) {
+        const DirtyRect *r = &g_dirtyRects[i];
+        if (x >= r->x0 && x <= r->x1 && y >= r->y0 && y <= r->y1) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Clip x/y/w/h to the screen. Returns false when nothing is left.
+static bool ClipRect(int *x, int *y, int *w, int *h)
+{
+    if (*x < 0) { *w += *x; *x = 0; }
+    if (*y < 0) { *h += *y; *y = 0; }
+    if (*x + *w > FRAMEBUFFER_WIDTH) *w = FRAMEBUFFER_WIDTH - *x;
+    if (*y + *h > FRAMEBUFFER_HEIGHT) *h = FRAMEBUFFER_HEIGHT - *y;
+    return (*w > 0) && (*h > 0);
+}
+
+//*****************************************************************************
+// Public API
+//*****************************************************************************
+void Framebuffer_Enable(bool enable)
+{
+    if (enable == g_framebufferEnabled) {
+        return;
+    }
+
+    if (enable) {
+        memset(g_framebuffer, 0, sizeof(g_framebuffer));
+        g_dirtyCount = 0;
+        g_framebufferEnabled = true;
+        AddDirtyRect(0, 0, FRAMEBUFFER_WIDTH - 1, FRAMEBUFFER_HEIGHT - 1);
+    } else {
+        Framebuffer_Flush();
+        g_framebufferEnabled = false;
+    }
+}
+
+bool Framebuffer_IsEnabled(void)
+{
+    return g_framebufferEnabled;
+}
+
+uint16_t* Framebuffer_GetBuffer(void)
+{
+    return g_framebuffer;
+}
+
+int Framebuffer_GetDirtyCount(void)
+{
+    return g_dirtyCount;
+}
+
+void Framebuffer_MarkDirty(int x, int y, int w, int h)
+{
+    if (!ClipRect(&x, &y, &w, &h)) {
+        return;
+    }
+    AddDirtyRect(x, y, x + w - 1, y + h - 1);
+}
+
+void Framebuffer_SetPixel(int x, int y, uint16_t color)
+{
+    uint16_t *p;
+
+    if ((x < 0) || (y < 0) || (x >= FRAMEBUFFER_WIDTH) || (y >= FRAMEBUFFER_HEIGHT)) {
+        return;
+    }
+
+    p = &g_framebuffer[y * FRAMEBUFFER_WIDTH + x];
+    if (*p == color) {
+        return;     // erase/redraw of an unchanged pixel costs nothing
+    }
+    *p = color;
+
+    if (!IsPixelDirty(x, y)) {
+        AddDirtyRect(x, y, x, y);
+    }
+}
+
+void Framebuffer_FillRect(int x, int y, int w, int h, uint16_t color)
+{
+    int i, j;
+    uint16_t *row;
+    bool changed = false;
+
+    if (!ClipRect(&x, &y, &w, &h)) {
+        return;
+    }
+
+    row = &g_framebuffer[y * FRAMEBUFFER_WIDTH + x];
+    for (j = 0; j < h; j++) {
+        for (i = 0; i < w; i++) {
+            if (row[i] != color) {
+                row[i] = color;
+                changed = true;
+            }
+        }
+        row += FRAMEBUFFER_WIDTH;
+    }
+
+    // Redrawing a span in the color it already has costs nothing on the bus
+    if (changed) {
+        AddDirtyRect(x, y, x + w - 1, y + h - 1);
+    }
+}
+
+// A bg_color of 1 leaves background pixels untouched, matching fastDrawBitmap
+void Framebuffer_DrawBitmap(int x, int y, const uint8_t *bitmap, int width, int height,
+                            uint16_t color, uint16_t bg_color, int pixelSize)
+{
+    int byteWidth = (width + 7) / 8;
+    int scaledWidth = width * pixelSize;
+    int scaledHeight = height * pixelSize;
+    int sx, sy;
+    int cx = x, cy = y, cw = scaledWidth, ch = scaledHeight;
+
+    if (pixelSize < 1 || !ClipRect(&cx, &cy, &cw, &ch)) {
+        return;
+    }
+
+    for (sy = cy; sy < cy + ch; sy++) {
+        int j = (sy - y) / pixelSize;
+        const uint8_t *src = &bitmap[j * byteWidth];
+        uint16_t *dst = &g_framebuffer[sy * FRAMEBUFFER_WIDTH];
+
+        for (sx = cx; sx < cx + cw; sx++) {
+            int i = (sx - x) / pixelSize;
+            if (src[i >> 3] & (0x80 >> (i & 7))) {
+                dst[sx] = color;
+            } else if (bg_color != 1) {
+                dst[sx] = bg_color;
+            }
+        }
+    }
+
+    AddDirtyRect(cx, cy, cx + cw - 1, cy + ch - 1);
+}
+
+static void SwapRows(int a, int b)
+{
+    uint16_t tmp[FRAMEBUFFER_WIDTH];
+    uint16_t *rowA = &g_framebuffer[a * FRAMEBUFFER_WIDTH];
+    uint16_t *rowB = &g_framebuffer[b * FRAMEBUFFER_WIDTH];
+
+    memcpy(tmp, rowA, sizeof(tmp));
+    memcpy(rowA, rowB, sizeof(tmp));
+    memcpy(rowB, tmp, sizeof(tmp));
+}
+
+static void ReverseRows(int first, int last)
+{
+    while (first < last) {
+        SwapRows(first++, last--);
+    }
+}
+
+// Rotate rows up by lines (three reversals, no second buffer needed)
+void Framebuffer_Scroll(int lines)
+{
+    int i;
+
+    lines %= FRAMEBUFFER_HEIGHT;
+    if (lines < 0) {
+        lines += FRAMEBUFFER_HEIGHT;
+    }
+    if (lines == 0) {
+        return;
+    }
+
+    ReverseRows(0, lines - 1);
+    ReverseRows(lines, FRAMEBUFFER_HEIGHT - 1);
+    ReverseRows(0, FRAMEBUFFER_HEIGHT - 1);
+
+    // Pending regions move with the content and may wrap, so widen them
+    for (i = 0; i < g_dirtyCount; i++) {
+        g_dirtyRects[i].y0 = 0;
+        g_dirtyRects[i].y1 = FRAMEBUFFER_HEIGHT - 1;
+    }
+}
+
+void Framebuffer_Flush(void)
+{
+    int k, sy;
+
+    if (!g_framebufferEnabled) {
+        return;
+    }
+
+    for (k = 0; k < g_dirtyCount; k++) {
+        const DirtyRect *r = &g_dirtyRects[k];
+        int w = r->x1 - r->x0 + 1;
+
+        // One window and one chip-select assertion per region
+        beginWindow(r->x0, r->y0, w, r->y1 - r->y0 + 1);
+        for (sy = r->y0; sy <= r->y1; sy++) {
+            pushPixels(&g_framebuffer[sy * FRAMEBUFFER_WIDTH + r->x0], w);
+        }
+        endWindow();
+    }
+
+    g_dirtyCount = 0;
+}
+
+#endif // FRAMEBUFFER_SUPPORT
@@ -0,0 +1,93 @@
+//*****************************************************************************
+// Shadow Framebuffer for the SSD1351 OLED
+// Keeps a full-screen RGB565 copy of the panel in RAM. While it is enabled the
+// Adafruit_OLED drawing primitives write into the copy and record dirty
+// rectangles instead of going to the SPI bus; Framebuffer_Flush() then sends
+// only the merged dirty regions, one column/row window per region.
+//*****************************************************************************
+
+#ifndef FRAMEBUFFER_H_
+#define FRAMEBUFFER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Set to 1 to build the 32KB shadow buffer into .bss. Off by default: it
+// would take a third of SRAM_DATA for the one app (the cube) that uses it,
+// and the cube draws straight to the panel without it.
+#ifndef FRAMEBUFFER_SUPPORT
+#define FRAMEBUFFER_SUPPORT     0
+#endif
+
+#define FRAMEBUFFER_WIDTH       128
+#define FRAMEBUFFER_HEIGHT      128
+
+// Maximum number of separate dirty regions kept between flushes. When the
+// list is full the two regions whose union wastes the fewest pixels are merged.
+#define FRAMEBUFFER_MAX_DIRTY   16
+
+// Two regions are merged as soon as their union costs no more than this many
+// extra pixels. Roughly what the column/row/WRITERAM setup of one extra
+// window costs on the bus, so merging below it never sends more bytes.
+#define FRAMEBUFFER_MERGE_SLACK 8
+
+#if FRAMEBUFFER_SUPPORT
+
+//*****************************************************************************
+// Enable or disable the shadow buffer
+// Enabling clears the buffer to black and marks the whole screen dirty so the
+// first flush brings the panel in sync. Disabling flushes pending regions.
+//*****************************************************************************
+void Framebuffer_Enable(bool enable);
+
+//*****************************************************************************
+// Returns true while drawing is being redirected into the shadow buffer
+//*****************************************************************************
+bool Framebuffer_IsEnabled(void);
+
+//*****************************************************************************
+// Drawing into the buffer (clipped to the screen, marks the area dirty)
+//*****************************************************************************
+void Framebuffer_SetPixel(int x, int y, uint16_t color);
+void Framebuffer_FillRect(int x, int y, int w, int h, uint16_t color);
+void Framebuffer_DrawBitmap(int x, int y, const uint8_t *bitmap, int width, int height,
+                            uint16_t color, uint16_t bg_color, int pixelSize);
+
+//*****************************************************************************
+// Direct access for callers that render straight into the buffer. The buffer
+// is row-major, FRAMEBUFFER_WIDTH pixels per row. Mark what you touched.
+//*****************************************************************************
+uint16_t* Framebuffer_GetBuffer(void);
+void Framebuffer_MarkDirty(int x, int y, int w, int h);
+
+//*****************************************************************************
+// Rotate the buffer up by lines rows to follow a hardware scroll. Called by
+// scrollLines(), which flushes first so nothing is left dirty.
+//*****************************************************************************
+void Framebuffer_Scroll(int lines);
+
+//*****************************************************************************
+// Send every dirty region to the panel and clear the dirty list
+//*****************************************************************************
+void Framebuffer_Flush(void);
+
+//*****************************************************************************
+// Number of dirty regions waiting for the next flush
+//*****************************************************************************
+int Framebuffer_GetDirtyCount(void);
+
+#else
+
+#define Framebuffer_Enable(enable)  ((void)(enable))
+#define Framebuffer_IsEnabled()     false
+#define Framebuffer_SetPixel(x, y, color)
+#define Framebuffer_FillRect(x, y, w, h, color)
+#define Framebuffer_DrawBitmap(x, y, bitmap, width, height, color, bg_color, pixelSize)
+#define Framebuffer_MarkDirty(x, y, w, h)
+#define Framebuffer_Scroll(lines)
+#define Framebuffer_Flush()
+#define Framebuffer_GetDirtyCount() 0
+
+#endif // FRAMEBUFFER_SUPPORT
+
+#endif /* FRAMEBUFFER_H_ */
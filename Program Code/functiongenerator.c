@@ -12,7 +12,6 @@
 #include "rom.h"
 #include "rom_map.h"
 #include "timer.h"
-#include <math.h>
 #include "adc.h"
 #include "hw_adc.h"
 #include "prcm.h"
@@ -59,6 +58,11 @@
 #define MIN_FREQUENCY        10       // Minimum frequency
 #define MAX_FREQUENCY        3000     // Maximum frequency
 
+// The visualizer's phase increment only fits 32 bits below this
+#if MAX_FREQUENCY >= 200 * SCOPE_BUFFER_SIZE
+#error "MAX_FREQUENCY is too high for the visualizer's phase accumulator"
+#endif
+
 //*****************************************************************************
 // Function Generator Parameters - Modify these as needed
 //*****************************************************************************
@@ -134,21 +138,20 @@ static void GenerateSquareWaveBuffer(unsigned long frequency)
         return;
     }
 
-    // Calculate phase increment per sample for continuous phase
+    // Out-of-range frequencies would overflow the phase increment
+    if (frequency > MAX_FREQUENCY) {
+        frequency = MAX_FREQUENCY;
+    }
+
+    // Phase accumulator: a full cycle is 2^32, so the 0-2pi wrap is free
     // Normalize frequency to 200Hz = 1 complete cycle across screen
-    float normalized_frequency = frequency / 200.0;
-    float phase_increment = (2.0 * M_PI * normalized_frequency) / SCOPE_BUFFER_SIZE;
+    uint32_t phase_increment = (uint32_t)(((uint64_t)frequency << 32) / (200 * SCOPE_BUFFER_SIZE));
+    uint32_t phase = 0;
 
     int i = 0;
-    for (i = 0; i < SCOPE_BUFFER_SIZE; i++) {
-        // Calculate continuous phase for this sample
-        float phase = i * phase_increment;
-
-        // Normalize phase to 0-2pi range
-        float normalized_phase = fmod(phase, 2.0 * M_PI);
-
+    for (i = 0; i < SCOPE_BUFFER_SIZE; i++, phase += phase_increment) {
         // Square wave: high for first half of cycle (0 to pi), low for second half (pi to 2pi)
-        if (normalized_phase < M_PI) {
+        if (phase < 0x80000000UL) {
             g_waveformBuffer[i] = MAX_AMPLITUDE;   // High state
         } else {
             g_waveformBuffer[i] = -MAX_AMPLITUDE;  // Low state
@@ -319,6 +322,10 @@ void FunctionGenerator_SetFrequency(unsigned long frequency)
         return;
     }
 
+    // Same range as the joystick gives
+    if (frequency > MAX_FREQUENCY) {
+        frequency = MAX_FREQUENCY;
+    }
     g_frequency = frequency;
 
     if (g_enabled) {
@@ -21,7 +21,7 @@ void FunctionGenerator_Initialize(void);
 //*****************************************************************************
 // Set Function Generator Frequency
 // Parameters:
-//   frequency - Output frequency in Hz
+//   frequency - Output frequency in Hz, clamped to the 3000Hz maximum
 //*****************************************************************************
 void FunctionGenerator_SetFrequency(unsigned long frequency);
 
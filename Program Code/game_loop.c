@@ -0,0 +1,100 @@
+//*****************************************************************************
+// Fixed-Timestep Game Loop
+// See game_loop.h for an overview.
+//*****************************************************************************
+
+// Standard includes
+#include <stdint.h>
+#include <stdbool.h>
+
+// Driverlib includes
+#include "hw_types.h"
+#include "hw_memmap.h"
+#include "timer.h"
+#include "prcm.h"
+#include "rom.h"
+#include "rom_map.h"
+
+#include "game_loop.h"
+
+//*****************************************************************************
+// Global Variables
+//*****************************************************************************
+static bool g_clockRunning = false;
+
+//*****************************************************************************
+// Public API
+//*****************************************************************************
+void GameLoop_InitClock(void)
+{
+    if (g_clockRunning) {
+        return;
+    }
+
+    // Full 32-bit up-counter at the system clock, never interrupts
+    MAP_PRCMPeripheralClkEnable(PRCM_TIMERA0, PRCM_RUN_MODE_CLK);
+    MAP_PRCMPeripheralReset(PRCM_TIMERA0);
+    MAP_TimerConfigure(TIMERA0_BASE, TIMER_CFG_PERIODIC_UP);
+    MAP_TimerLoadSet(TIMERA0_BASE, TIMER_A, 0xFFFFFFFF);
+    MAP_TimerEnable(TIMERA0_BASE, TIMER_A);
+
+    g_clockRunning = true;
+}
+
+uint32_t GameLoop_Ticks(void)
+{
+    return (uint32_t)MAP_TimerValueGet(TIMERA0_BASE, TIMER_A);
+}
+
+void GameLoop_Init(GameLoop *loop, unsigned int rateHz, int maxSteps)
+{
+    GameLoop_InitClock();
+
+    loop->stepTicks = GAME_LOOP_TICKS_PER_SEC / rateHz;
+    loop->maxSteps = (maxSteps < 1) ? 1 : maxSteps;
+    loop->frameTicks = 0;
+    loop->frames = 0;
+    loop->steps = 0;
+    loop->droppedSteps = 0;
+    GameLoop_Resync(loop);
+}
+
+void GameLoop_Resync(GameLoop *loop)
+{
+    loop->lastTicks = GameLoop_Ticks();
+    loop->accumulator = 0;
+}
+
+int GameLoop_StepsDue(GameLoop *loop)
+{
+    uint32_t now = GameLoop_Ticks();
+    uint32_t steps;
+
+    loop->frameTicks = now - loop->lastTicks;
+    loop->lastTicks = now;
+    loop->frames++;
+
+    loop->accumulator += loop->frameTicks;
+    steps = loop->accumulator / loop->stepTicks;
+    loop->accumulator -= steps * loop->stepTicks;
+
+    // Too far behind to catch up: run the cap, drop the rest
+    if (steps > (uint32_t)loop->maxSteps) {
+        loop->droppedSteps += steps - loop->maxSteps;
+        steps = loop->maxSteps;
+    }
+
+    loop->steps += steps;
+    return (int)steps;
+}
+
+unsigned long GameLoop_TimeMs(const GameLoop *loop)
+{
+    return (unsigned long)(((uint64_t)loop->steps * loop->stepTicks) /
+                           (GAME_LOOP_TICKS_PER_SEC / 1000));
+}
+
+unsigned long GameLoop_FrameTimeUs(const GameLoop *loop)
+{
+    return loop->frameTicks / GAME_LOOP_TICKS_PER_US;
+}
@@ -0,0 +1,70 @@
+//*****************************************************************************
+// Fixed-Timestep Game Loop
+// A monotonic tick source on TIMERA0 (free-running at the 80MHz system
+// clock) and the accumulator that turns measured frame times into a whole
+// number of fixed physics steps. Each frame asks how many steps are due,
+// runs them, then renders once, so game speed no longer depends on how long
+// drawing and asset reads take. Steps beyond the per-frame cap are dropped
+// and counted rather than run, so a slow frame cannot snowball.
+//*****************************************************************************
+
+#ifndef GAME_LOOP_H_
+#define GAME_LOOP_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define GAME_LOOP_TICKS_PER_SEC     80000000UL
+#define GAME_LOOP_TICKS_PER_US      80
+
+typedef struct {
+    uint32_t stepTicks;             // length of one physics step
+    uint32_t lastTicks;             // clock at the previous GameLoop_StepsDue()
+    uint32_t accumulator;           // measured time not yet simulated
+    int maxSteps;                   // most steps run in one frame
+    uint32_t frameTicks;            // length of the last frame
+    unsigned long frames;
+    unsigned long steps;            // steps run since GameLoop_Init()
+    unsigned long droppedSteps;     // steps skipped by the per-frame cap
+} GameLoop;
+
+//*****************************************************************************
+// Start the tick source if it is not running yet. GameLoop_Init() calls this.
+//*****************************************************************************
+void GameLoop_InitClock(void);
+
+//*****************************************************************************
+// Current tick count. Wraps about every 53 seconds; differences between two
+// readings taken less than that apart are always right.
+//*****************************************************************************
+uint32_t GameLoop_Ticks(void);
+
+//*****************************************************************************
+// Set a loop up for rateHz physics steps and at most maxSteps per frame,
+// with its counters cleared
+//*****************************************************************************
+void GameLoop_Init(GameLoop *loop, unsigned int rateHz, int maxSteps);
+
+//*****************************************************************************
+// Forget the time since the last frame, e.g. after loading a level, so it is
+// neither simulated nor counted as dropped
+//*****************************************************************************
+void GameLoop_Resync(GameLoop *loop);
+
+//*****************************************************************************
+// Call once per frame: measures the frame and returns how many physics steps
+// to run now (0 when the frame was shorter than a step)
+//*****************************************************************************
+int GameLoop_StepsDue(GameLoop *loop);
+
+//*****************************************************************************
+// Simulated time in milliseconds, from the steps run so far
+//*****************************************************************************
+unsigned long GameLoop_TimeMs(const GameLoop *loop);
+
+//*****************************************************************************
+// Length of the last frame in microseconds
+//*****************************************************************************
+unsigned long GameLoop_FrameTimeUs(const GameLoop *loop);
+
+#endif /* GAME_LOOP_H_ */
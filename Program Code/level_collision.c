@@ -0,0 +1,175 @@
+//*****************************************************************************
+// Level Collision Data
+// See level_collision.h for an overview.
+//*****************************************************************************
+
+// Standard includes
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "level_collision.h"
+
+#define ROW_BYTES               (LEVEL_COLLISION_WIDTH / 8)
+#define TILE_COLUMNS            (LEVEL_COLLISION_WIDTH >> LEVEL_COLLISION_TILE_SHIFT)
+#define TILE_ROWS               (LEVEL_COLLISION_HEIGHT >> LEVEL_COLLISION_TILE_SHIFT)
+
+// Run count marking a row whose runs did not fit in g_runs
+#define ROW_DENSE               0xFF
+
+//*****************************************************************************
+// Global Variables
+//*****************************************************************************
+static uint8_t g_bits[LEVEL_COLLISION_HEIGHT][ROW_BYTES];  // map copy, y up
+static LevelRun g_runs[LEVEL_COLLISION_MAX_RUNS];
+static uint16_t g_rowFirstRun[LEVEL_COLLISION_HEIGHT];
+static uint8_t g_rowRunCount[LEVEL_COLLISION_HEIGHT];
+static uint8_t g_columnTop[LEVEL_COLLISION_WIDTH];
+static uint16_t g_tileRows[TILE_ROWS];                      // bit tx of row ty
+static LevelRun g_denseRuns[LEVEL_COLLISION_WIDTH / 2];
+
+//*****************************************************************************
+// Helpers
+//*****************************************************************************
+
+// Decode the runs of row y from the bit copy into out
+static int DecodeRuns(int y, LevelRun *out, int max)
+{
+    int count = 0;
+    int x = 0;
+
+    while (x < LEVEL_COLLISION_WIDTH && count < max) {
+        int start;
+
+        if (!LevelCollision_IsSolid(x, y)) {
+            x++;
+            continue;
+        }
+        start = x;
+        while (x + 1 < LEVEL_COLLISION_WIDTH && LevelCollision_IsSolid(x + 1, y)) {
+            x++;
+        }
+        out[count].start = (uint8_t)start;
+        out[count].end = (uint8_t)x;
+        count++;
+        x++;
+    }
+    return count;
+}
+
+//*****************************************************************************
+// Public API
+//*****************************************************************************
+void LevelCollision_Build(const uint8_t *bitmap, int width, int height)
+{
+    int byteWidth = (width + 7) / 8;
+    int copyBytes, x, y, r;
+    int runTotal = 0;
+
+    memset(g_bits, 0, sizeof(g_bits));
+    memset(g_columnTop, 0, sizeof(g_columnTop));
+    memset(g_tileRows, 0, sizeof(g_tileRows));
+
+    if (width > LEVEL_COLLISION_WIDTH) width = LEVEL_COLLISION_WIDTH;
+    if (height > LEVEL_COLLISION_HEIGHT) height = LEVEL_COLLISION_HEIGHT;
+    copyBytes = (width + 7) / 8;
+
+    // Flip the rows so y counts up, dropping any bits past width
+    for (y = 0; y < height; y++) {
+        memcpy(g_bits[y], bitmap + (height - 1 - y) * byteWidth, copyBytes);
+        if (width & 7) {
+            g_bits[y][copyBytes - 1] &= (uint8_t)(0xFF00 >> (width & 7));
+        }
+    }
+
+    for (y = 0; y < LEVEL_COLLISION_HEIGHT; y++) {
+        LevelRun rowRuns[LEVEL_COLLISION_WIDTH / 2];
+        int count = DecodeRuns(y, rowRuns, LEVEL_COLLISION_WIDTH / 2);
+
+        for (r = 0; r < count; r++) {
+            int tx;
+
+            // Rows go bottom up, so the last solid row seen is the surface
+            for (x = rowRuns[r].start; x <= rowRuns[r].end; x++) {
+                g_columnTop[x] = (uint8_t)(y + 1);
+            }
+            for (tx = rowRuns[r].start >> LEVEL_COLLISION_TILE_SHIFT;
+                 tx <= rowRuns[r].end >> LEVEL_COLLISION_TILE_SHIFT; tx++) {
+                g_tileRows[y >> LEVEL_COLLISION_TILE_SHIFT] |= (uint16_t)(1 << tx);
+            }
+        }
+
+        g_rowFirstRun[y] = (uint16_t)runTotal;
+        if (runTotal + count <= LEVEL_COLLISION_MAX_RUNS) {
+            memcpy(&g_runs[runTotal], rowRuns, count * sizeof(LevelRun));
+            g_rowRunCount[y] = (uint8_t)count;
+            runTotal += count;
+        } else {
+            g_rowRunCount[y] = ROW_DENSE;
+        }
+    }
+}
+
+int LevelCollision_GetRuns(int y, const LevelRun **runs)
+{
+    if (y < 0 || y >= LEVEL_COLLISION_HEIGHT) {
+        return 0;
+    }
+
+    if (g_rowRunCount[y] == ROW_DENSE) {
+        *runs = g_denseRuns;
+        return DecodeRuns(y, g_denseRuns, LEVEL_COLLISION_WIDTH / 2);
+    }
+
+    *runs = &g_runs[g_rowFirstRun[y]];
+    return g_rowRunCount[y];
+}
+
+int LevelCollision_SurfaceHeight(int x0, int x1)
+{
+    int top = 0;
+    int x;
+
+    if (x0 < 0) x0 = 0;
+    if (x1 >= LEVEL_COLLISION_WIDTH) x1 = LEVEL_COLLISION_WIDTH - 1;
+
+    for (x = x0; x <= x1; x++) {
+        if (g_columnTop[x] > top) {
+            top = g_columnTop[x];
+        }
+    }
+    return top;
+}
+
+bool LevelCollision_AnySolid(int x0, int y0, int x1, int y1)
+{
+    uint16_t columns;
+    int ty;
+
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 >= LEVEL_COLLISION_WIDTH) x1 = LEVEL_COLLISION_WIDTH - 1;
+    if (y1 >= LEVEL_COLLISION_HEIGHT) y1 = LEVEL_COLLISION_HEIGHT - 1;
+    if (x0 > x1 || y0 > y1) {
+        return false;
+    }
+
+    // Tile columns x0 to x1 as a bit mask
+    columns = (uint16_t)((0xFFFF << (x0 >> LEVEL_COLLISION_TILE_SHIFT)) &
+                         (0xFFFF >> (TILE_COLUMNS - 1 - (x1 >> LEVEL_COLLISION_TILE_SHIFT))));
+
+    for (ty = y0 >> LEVEL_COLLISION_TILE_SHIFT; ty <= y1 >> LEVEL_COLLISION_TILE_SHIFT; ty++) {
+        if (g_tileRows[ty] & columns) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool LevelCollision_IsSolid(int x, int y)
+{
+    if (x < 0 || x >= LEVEL_COLLISION_WIDTH || y < 0 || y >= LEVEL_COLLISION_HEIGHT) {
+        return false;
+    }
+    return (g_bits[y][x >> 3] & (0x80 >> (x & 7))) != 0;
+}
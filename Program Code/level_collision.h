@@ -0,0 +1,62 @@
+//*****************************************************************************
+// Level Collision Data
+// Built once from a 1bpp level map when the map loads, so per-step collision
+// queries touch only the pixels near the player instead of the whole map.
+// Coordinates are the platformer's: x to the right, y up from the bottom
+// row, and pixel (x, y) covers [x, x+1) by [y, y+1).
+//
+// Three structures are kept:
+//   per-row solid runs      x ranges of solid pixels, left to right
+//   per-column surfaces     top edge of the highest solid pixel
+//   tile occupancy          one bit per 8x8 tile holding any solid pixel
+//*****************************************************************************
+
+#ifndef LEVEL_COLLISION_H_
+#define LEVEL_COLLISION_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define LEVEL_COLLISION_WIDTH       128
+#define LEVEL_COLLISION_HEIGHT      128
+
+#define LEVEL_COLLISION_TILE_SHIFT  3
+#define LEVEL_COLLISION_TILE_SIZE   (1 << LEVEL_COLLISION_TILE_SHIFT)
+
+// Run storage for the whole map. Rows that do not fit are decoded from a
+// copy of the map bits when queried.
+#define LEVEL_COLLISION_MAX_RUNS    1024
+
+// A horizontal run of solid pixels, start to end inclusive
+typedef struct {
+    uint8_t start;
+    uint8_t end;
+} LevelRun;
+
+//*****************************************************************************
+// Build the collision data from a map in drawBitmap() layout (rows top
+// down, MSB first). Sizes larger than the supported map are clipped.
+//*****************************************************************************
+void LevelCollision_Build(const uint8_t *bitmap, int width, int height);
+
+//*****************************************************************************
+// Solid runs of row y, left to right. *runs stays valid until the next
+// query. Returns the number of runs, 0 outside the map.
+//*****************************************************************************
+int LevelCollision_GetRuns(int y, const LevelRun **runs);
+
+//*****************************************************************************
+// Highest surface over columns x0 to x1: the top edge of the highest solid
+// pixel, 0 if the columns are empty
+//*****************************************************************************
+int LevelCollision_SurfaceHeight(int x0, int x1);
+
+//*****************************************************************************
+// True if any tile touching the rectangle (inclusive, clipped to the map)
+// holds a solid pixel. May report tiles whose solid pixels lie just outside.
+//*****************************************************************************
+bool LevelCollision_AnySolid(int x0, int y0, int x1, int y1);
+
+bool LevelCollision_IsSolid(int x, int y);
+
+#endif /* LEVEL_COLLISION_H_ */
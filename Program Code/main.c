@@ -45,6 +45,11 @@
 #include "video_game.h"
 #include "AWS_IoT.h"
 #include "functiongenerator.h"
+#include "display_dma.h"
+#include "fast_math.h"
+#include "accel_sampler.h"
+#include "asset_manager.h"
+#include "animation_player.h"
 
 /*============================================================================
  * CONSTANTS AND DEFINITIONS
@@ -65,6 +70,7 @@
 #define SCREEN_HEIGHT           128
 #define SCREEN_CENTER_X         (SCREEN_WIDTH / 2)
 #define SCREEN_CENTER_Y         (SCREEN_HEIGHT / 2)
+#define INTRO_ANIMATION_FILE    "/intro.anim"
 
 /* Button constants */
 #define BUTTON1_PIN             0x40    /* PIN_15 */
@@ -81,12 +87,6 @@
 #define SYSTEM_CLOCK_FREQ       80000000
 #define TICKS_TO_MS(ticks)      ((ticks) / (SYSTEM_CLOCK_FREQ / 1000))
 
-/* Accelerometer constants */
-#define ACCEL_I2C_ADDR          0x18
-#define ACCEL_REG_X             0x03
-#define ACCEL_REG_Y             0x05
-#define ACCEL_REG_Z             0x07
-
 /* ADC constants */
 #define ADC_SAMPLE_COUNT        10
 #define ADC_REFERENCE_VOLTAGE   1.4f
@@ -130,7 +130,6 @@ typedef struct {
     char* currentInterface;
     char previousSelectedOption;
     char selectedOption;
-    int animationDelay;
     bool firstIntroFrame;
 } GameState;
 
@@ -171,6 +170,7 @@ static volatile unsigned long sysTickWrapCounter = 0;
 
 /* Application state */
 static bool videogameInitialized = false;
+static AnimationPlayer introAnimation;
 
 /*============================================================================
  * FUNCTION PROTOTYPES
@@ -279,6 +279,11 @@ void init_simplelink(void)
     sl_WlanPolicySet(SL_POLICY_CONNECTION, SL_CONNECTION_POLICY(0, 0, 0, 0, 0), NULL, 0);
 
     UART_PRINT("SimpleLink initialized for file operations\n\r");
+
+    /* Serve bitmap frames from the packed archive when one is uploaded */
+    if (AssetManager_OpenArchive() == SUCCESS) {
+        UART_PRINT("Asset archive opened\n\r");
+    }
 }
 
 /*============================================================================
@@ -286,31 +291,24 @@ void init_simplelink(void)
  *============================================================================*/
 
 /**
- * Read accelerometer data from BMA222
- * @return SUCCESS on success, FAILURE on error
+ * Read accelerometer data from BMA222. While the background sampler is
+ * running this copies its newest sample instead of touching the bus.
+ * @return SUCCESS on success, FAILURE on error or if no sample has arrived yet
  */
 int ReadAccelerometerData(void)
 {
-    unsigned char ucDevAddr = ACCEL_I2C_ADDR;
-    unsigned char ucRegX = ACCEL_REG_X;
-    unsigned char ucRegY = ACCEL_REG_Y;
-    unsigned char ucRegZ = ACCEL_REG_Z;
-    unsigned char ucData = 0;
-
-    /* Read X-axis */
-    if(I2C_IF_Write(ucDevAddr, &ucRegX, 1, 0) != SUCCESS) return FAILURE;
-    if(I2C_IF_Read(ucDevAddr, &ucData, 1) != SUCCESS) return FAILURE;
-    g_iAccelX = (int8_t)ucData;
-
-    /* Read Y-axis */
-    if(I2C_IF_Write(ucDevAddr, &ucRegY, 1, 0) != SUCCESS) return FAILURE;
-    if(I2C_IF_Read(ucDevAddr, &ucData, 1) != SUCCESS) return FAILURE;
-    g_iAccelY = (int8_t)ucData;
-
-    /* Read Z-axis */
-    if(I2C_IF_Write(ucDevAddr, &ucRegZ, 1, 0) != SUCCESS) return FAILURE;
-    if(I2C_IF_Read(ucDevAddr, &ucData, 1) != SUCCESS) return FAILURE;
-    g_iAccelZ = (int8_t)ucData;
+    AccelSample sample;
+
+    if (AccelSampler_IsRunning()) {
+        if (!AccelSampler_GetLatest(&sample)) return FAILURE;
+    } else {
+        /* One burst read of all three axes */
+        if (AccelSampler_ReadBurst(&sample) != SUCCESS) return FAILURE;
+    }
+
+    g_iAccelX = sample.x;
+    g_iAccelY = sample.y;
+    g_iAccelZ = sample.z;
 
     return SUCCESS;
 }
@@ -497,6 +495,12 @@ void initializeHardware(void)
     MAP_SPIEnable(GSPI_BASE);
     Adafruit_Init();
 
+    /* Background display transfers for full-screen frames */
+    Display_DmaInit();
+
+    /* Sine table for the 3D apps, built once here instead of on first use */
+    FastMath_Init();
+
     /* Initialize buttons and sound */
     InitializeBothButtons();
     InitSoundEffects();
@@ -549,7 +553,6 @@ void initializeGameState(GameState* state)
     state->currentInterface = "intro";
     state->previousSelectedOption = 1;
     state->selectedOption = 1;
-    state->animationDelay = 800000;
     state->firstIntroFrame = true;
 }
 
@@ -804,19 +807,29 @@ void renderInterface(GameState* state)
  */
 void renderIntroScreen(GameState* state)
 {
-    const uint8_t* INTRO_frame_bitmap;
-
-    INTRO_frame_bitmap = get_INTRO_frame((state->introFrame) % INTRO_FRAME_COUNT);
-    fastDrawBitmap(0, 0, INTRO_frame_bitmap, 128, 128, GREEN, BLACK, 1);
-    state->introFrame++;
-    MAP_UtilsDelay(state->animationDelay);
+    uint16_t frameCount;
+
+    /* Keyframe on the first call, then only the changed tiles once each
+     * frame period; calls in between return without drawing */
+    if (state->introFrame == 0) {
+        AnimationPlayer_OpenFrames(&introAnimation, INTRO_ANIMATION_FILE,
+                                   get_INTRO_frame, INTRO_FRAME_COUNT);
+        AnimationPlayer_Start(&introAnimation, 0, 0, GREEN, BLACK);
+        state->introFrame = 1;
+    }
+    frameCount = AnimationPlayer_GetFrameCount(&introAnimation);
+    if (state->introFrame < frameCount && AnimationPlayer_Update(&introAnimation)) {
+        state->introFrame++;
+    }
 
     if(state->firstIntroFrame) {
         PlayIntroSound();
         state->firstIntroFrame = false;
     }
 
-    if (state->introFrame >= INTRO_FRAME_COUNT) {
+    /* The last frame stays up for a whole period like the others */
+    if (state->introFrame >= frameCount && AnimationPlayer_IsDue(&introAnimation)) {
+        AnimationPlayer_Close(&introAnimation);
         state->currentInterface = "optionScreen";
         state->hideCursor = false;
     }
@@ -827,11 +840,8 @@ void renderIntroScreen(GameState* state)
  */
 void renderOptionScreen(GameState* state)
 {
-    const uint8_t* optionBackground_frame_bitmap;
-
-    optionBackground_frame_bitmap = get_optionBackground_frame(state->optionBackgroundFrame);
-    fastDrawBitmap(0, 0, optionBackground_frame_bitmap, OPTIONBACKGROUND_WIDTH,
-                  OPTIONBACKGROUND_HEIGHT, GREEN, BLACK, 1);
+    Display_WaitIdle();
+    AssetManager_DrawFrame(ASSET_OPTION_BACKGROUND, state->optionBackgroundFrame, 0, 0, GREEN, BLACK);
 }
 
 /**
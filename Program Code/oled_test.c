@@ -12,6 +12,9 @@
 #include "oled_test.h"
 #include "Adafruit_GFX.h"
 #include "Adafruit_SSD1351.h"
+#include "uart_if.h"
+#include "pixel_batch.h"
+#include "systick.h"
 
 static float p = 3.1415926;
 
@@ -234,3 +237,149 @@ void lcdTestPattern2(void)
 
 /**************************************************************************/
 
+#if SSD1351_STATS
+// Bresenham line plotted one drawPixel() at a time, the way drawLine() drew
+// before it emitted spans, so the per-pixel cost can still be measured
+static void drawLinePixels(int x0, int y0, int x1, int y1, unsigned int color)
+{
+  int dx = (x1 > x0) ? x1 - x0 : x0 - x1;
+  int dy = (y1 > y0) ? y0 - y1 : y1 - y0;
+  int sx = (x0 < x1) ? 1 : -1;
+  int sy = (y0 < y1) ? 1 : -1;
+  int err = dx + dy;
+
+  for (;;) {
+    int e2 = 2 * err;
+
+    drawPixel(x0, y0, color);
+    if (x0 == x1 && y0 == y1) break;
+    if (e2 >= dy) { err += dy; x0 += sx; }
+    if (e2 <= dx) { err += dx; y0 += sy; }
+  }
+}
+
+//*****************************************************************************
+// Draw a fixed workload with each primitive and print the bytes and
+// chip-select assertions it cost on the bus over UART
+//*****************************************************************************
+void testPrimitiveStats(void)
+{
+  static const uint8_t checker[8] = {0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55};
+  unsigned int i;
+
+  resetDisplayStats();
+
+  for (i = 0; i < 128; i++) {
+    drawPixel(i, i, WHITE);
+  }
+  for (i = 0; i < 128; i += 4) {
+    drawFastHLine(0, i, 128, GREEN);
+    drawFastVLine(i, 0, 128, BLUE);
+  }
+  for (i = 0; i < 16; i++) {
+    fillRect(i * 8, i * 8, 16, 16, RED);
+  }
+  fastFillScreen(BLACK);
+  for (i = 0; i < 16; i++) {
+    fastDrawBitmap(i * 8, 60, checker, 8, 8, YELLOW, BLACK, 1);
+  }
+
+  reportDisplayStats();
+
+  // Same wireframe-style workload drawn directly and through a pixel batch.
+  // Batched runs are booked under "other".
+  fillScreen(BLACK);
+  resetDisplayStats();
+  for (i = 0; i < 128; i += 8) {
+    drawLinePixels(0, i, 127, 127 - i, CYAN);
+    drawLinePixels(0, i, 127, 127 - i, BLACK);
+    drawLinePixels(i, 0, 127 - i, 127, CYAN);
+  }
+  Report("direct drawPixel:\n\r");
+  reportDisplayStats();
+
+  fillScreen(BLACK);
+  resetDisplayStats();
+  PixelBatch_Begin();
+  for (i = 0; i < 128; i += 8) {
+    drawLine(0, i, 127, 127 - i, CYAN);
+    drawLine(0, i, 127, 127 - i, BLACK);
+    drawLine(i, 0, 127 - i, 127, CYAN);
+  }
+  PixelBatch_End();
+  Report("batched drawPixel:\n\r");
+  reportDisplayStats();
+
+  // The same lines again through drawLine(), which sends each run of
+  // pixels as one fast line outside a batch
+  fillScreen(BLACK);
+  resetDisplayStats();
+  for (i = 0; i < 128; i += 8) {
+    drawLine(0, i, 127, 127 - i, CYAN);
+    drawLine(0, i, 127, 127 - i, BLACK);
+    drawLine(i, 0, 127 - i, 127, CYAN);
+  }
+  Report("span lines:\n\r");
+  reportDisplayStats();
+
+  // Oscilloscope-style label redraw, glyphs go out through one window per line
+  fillScreen(BLACK);
+  resetDisplayStats();
+  for (i = 0; i < 10; i++) {
+    Outstr("1.40", GREEN, BLACK, 12, 27, 128, 50);
+    Outstr("0V", GREEN, BLACK, 12, 86, 118, 115);
+    Outstr("1000Hz       ", GREEN, BLACK, 26, 121, 128, 128);
+  }
+  Report("text labels:\n\r");
+  reportDisplayStats();
+}
+
+//*****************************************************************************
+// Time full-screen 1bpp blits through the lookup-table path and the per-bit
+// reference loop with a free-running SysTick (80MHz, 24-bit) and print the
+// pixel rate of each over UART
+//*****************************************************************************
+static unsigned long timeBitmap(bool lut, const uint8_t *bitmap, int size, int pixelSize)
+{
+  unsigned long start, end;
+
+  start = SysTickValueGet();
+  if (lut) {
+    fastDrawBitmap(0, 0, bitmap, size, size, GREEN, BLACK, pixelSize);
+  } else {
+    fastDrawBitmapBitwise(0, 0, bitmap, size, size, GREEN, BLACK, pixelSize);
+  }
+  end = SysTickValueGet();
+
+  return (start - end) & 0xFFFFFF;   // counts down
+}
+
+void testBitmapThroughput(void)
+{
+  static uint8_t pattern[128 * 128 / 8];
+  unsigned long ticks;
+  unsigned int i;
+  int pixelSize;
+
+  for (i = 0; i < sizeof(pattern); i++) {
+    pattern[i] = (uint8_t)(i * 37 + (i >> 4));
+  }
+
+  SysTickDisable();
+  SysTickIntDisable();
+  SysTickPeriodSet(0xFFFFFF);
+  SysTickEnable();
+
+  for (pixelSize = 1; pixelSize <= 2; pixelSize++) {
+    int size = 128 / pixelSize;
+
+    ticks = timeBitmap(false, pattern, size, pixelSize);
+    Report("bitwise x%d: %lu ticks, %lu px/s\n\r", pixelSize, ticks,
+           (unsigned long)(16384ULL * 80000000ULL / ticks));
+
+    ticks = timeBitmap(true, pattern, size, pixelSize);
+    Report("lut     x%d: %lu ticks, %lu px/s\n\r", pixelSize, ticks,
+           (unsigned long)(16384ULL * 80000000ULL / ticks));
+  }
+}
+#endif
@@ -29,6 +29,8 @@ void testroundrects();
 void testlines(unsigned int color);
 void lcdTestPattern(void);
 void lcdTestPattern2(void);
+void testPrimitiveStats(void);   // requires SSD1351_STATS
+void testBitmapThroughput(void); // requires SSD1351_STATS
 
 
 #endif /* OLED_OLED_TEST_H_ */
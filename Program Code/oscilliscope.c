@@ -27,6 +27,7 @@
 // App includes
 #include "Adafruit_GFX.h"
 #include "Adafruit_SSD1351.h"
+#include "pixel_batch.h"
 
 // UI settings
 #define SCREEN_WIDTH         128
@@ -383,6 +384,10 @@ static void DrawOscilloscope(void)
     // Draw static elements only once
     static bool static_elements_drawn = false;
 
+    // Queue the per-pixel text and trace drawing so erase and redraw of the
+    // same pixel collapse into one write and runs share a window
+    PixelBatch_Begin();
+
     // Draw voltage scale labels
     sprintf(buffer, "%.2f", voltageStep);
     Outstr(buffer, GREEN, BLACK, 12, 27, 128, 50);
@@ -454,6 +459,7 @@ static void DrawOscilloscope(void)
     sprintf(buffer, "%.2f", voltageStep);
     Outstr(buffer, GREEN, BLACK, 76, 119, 128, 128);
 
+    PixelBatch_End();
 }
 
 //*****************************************************************************
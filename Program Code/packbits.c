@@ -0,0 +1,42 @@
+//*****************************************************************************
+// PackBits
+// See packbits.h for the format.
+//*****************************************************************************
+
+// Standard includes
+#include <stdint.h>
+#include <string.h>
+
+#include "packbits.h"
+
+long PackBits_Decode(const uint8_t *src, unsigned long length,
+                     uint8_t *dest, unsigned long destLength)
+{
+    const uint8_t *end = src + length;
+    unsigned long written = 0;
+
+    while (src < end) {
+        int n = (int8_t)*src++;
+        unsigned long count;
+
+        if (n >= 0) {
+            count = n + 1;
+            if ((unsigned long)(end - src) < count || destLength - written < count) {
+                return -1;
+            }
+            memcpy(dest + written, src, count);
+            src += count;
+        } else if (n != -128) {
+            count = 1 - n;
+            if (src >= end || destLength - written < count) {
+                return -1;
+            }
+            memset(dest + written, *src++, count);
+        } else {
+            continue;
+        }
+        written += count;
+    }
+
+    return (long)written;
+}
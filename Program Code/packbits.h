@@ -0,0 +1,27 @@
+//*****************************************************************************
+// PackBits
+// Byte-oriented run-length coding for the 1bpp bitmap assets, the same
+// scheme as Apple PackBits / TIFF compression 32773. The stream is a series
+// of chunks, each led by a signed header byte n:
+//   0 to 127      n + 1 literal bytes follow
+//   -127 to -1    the next byte repeats 1 - n times (2 to 128)
+//   -128          no-op
+// Frames are coded row after row with no break at row ends, so mostly
+// black screens shrink to a few runs of 0x00. The encoder is in
+// Helper Programs/bitmap_converter.py; fastDrawBitmapPackBits() in the
+// display driver decodes straight into the display window.
+//*****************************************************************************
+
+#ifndef PACKBITS_H_
+#define PACKBITS_H_
+
+#include <stdint.h>
+
+//*****************************************************************************
+// Decode length bytes of src into dest (destLength bytes). Returns the
+// number of bytes written, or -1 if src is truncated or would overrun dest.
+//*****************************************************************************
+long PackBits_Decode(const uint8_t *src, unsigned long length,
+                     uint8_t *dest, unsigned long destLength);
+
+#endif /* PACKBITS_H_ */
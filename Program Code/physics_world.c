@@ -0,0 +1,425 @@
+//*****************************************************************************
+// Physics World
+// See physics_world.h for an overview. All bodies are unit-mass cubes of the
+// same size, so contact impulses split evenly between the pair.
+//*****************************************************************************
+
+// Standard includes
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "fixed3d.h"
+#include "fast_math.h"
+#include "physics_world.h"
+
+#if PHYSICS_WORLD_BENCHMARK
+#include "systick.h"
+#include "uart_if.h"
+#endif
+
+// Simulation parameters
+#define GRAVITY_STRENGTH      1.1f    // Strength of gravity
+#define DAMPING               0.98f   // Velocity damping (energy loss)
+#define ANGULAR_DAMPING       0.25f   // Angular velocity damping
+#define RESTITUTION           0.5f    // Bounciness (0 = no bounce, 1 = perfect bounce)
+#define TIME_STEP             0.9f    // Physics time step
+#define STABILIZATION_STRENGTH 0.02f  // Strength of the stabilizing torque
+
+#define NUM_CORNERS             8
+#define NUM_FACES               6
+
+//*****************************************************************************
+// Global Variables
+//*****************************************************************************
+static int g_bodyCount = 0;
+
+// Body state, one entry per body
+static float g_posX[PHYSICS_MAX_BODIES];
+static float g_posY[PHYSICS_MAX_BODIES];
+static float g_posZ[PHYSICS_MAX_BODIES];
+static float g_velX[PHYSICS_MAX_BODIES];
+static float g_velY[PHYSICS_MAX_BODIES];
+static float g_velZ[PHYSICS_MAX_BODIES];
+static float g_angVelX[PHYSICS_MAX_BODIES];
+static float g_angVelY[PHYSICS_MAX_BODIES];
+static float g_angVelZ[PHYSICS_MAX_BODIES];
+static Fixed3D_Quat g_orientation[PHYSICS_MAX_BODIES];
+static Fixed3D_Matrix g_rotation[PHYSICS_MAX_BODIES];  // from g_orientation, once per step
+
+// Body indices ordered by the low end of their X interval, kept between
+// steps so the insertion sort only has to fix up what moved
+static uint8_t g_sortedX[PHYSICS_MAX_BODIES];
+
+// Shared body shape
+static float g_boundRadius;     // bounding sphere, for the broadphase
+static float g_contactRadius;   // narrowphase sphere
+static float g_boxMin[3];
+static float g_boxMax[3];
+static fixed_t g_corners[NUM_CORNERS][3];
+
+static fixed_t g_faceNormals[NUM_FACES][3] = {
+    { 0,             0,            -FIXED3D_ONE},
+    { 0,             0,             FIXED3D_ONE},
+    { 0,            -FIXED3D_ONE,   0},
+    { 0,             FIXED3D_ONE,   0},
+    {-FIXED3D_ONE,   0,             0},
+    { FIXED3D_ONE,   0,             0}
+};
+
+//*****************************************************************************
+// Per-body passes
+//*****************************************************************************
+
+// Torque that turns the face closest to facing down the rest of the way
+static void StabilizingTorque(int b, float gravityX, float gravityY, float gravityZ,
+                              float* torqueX, float* torqueY, float* torqueZ)
+{
+    fixed_t worldNormals[NUM_FACES][3];
+    float bestAlignment = -1.0f;  // Dot product closest to -1 (face down)
+    int bestFace = -1;
+    int i;
+
+    *torqueX = 0.0f;
+    *torqueY = 0.0f;
+    *torqueZ = 0.0f;
+
+    Fixed3D_TransformVectors(&g_rotation[b], g_faceNormals, worldNormals, NUM_FACES);
+
+    for (i = 0; i < NUM_FACES; i++) {
+        float dotProduct = FIXED3D_TO_FLOAT(worldNormals[i][0]) * gravityX +
+                           FIXED3D_TO_FLOAT(worldNormals[i][1]) * gravityY +
+                           FIXED3D_TO_FLOAT(worldNormals[i][2]) * gravityZ;
+        if (dotProduct < bestAlignment) {
+            bestAlignment = dotProduct;
+            bestFace = i;
+        }
+    }
+
+    if (bestFace != -1 && bestAlignment > -0.99f) {
+        float nx = FIXED3D_TO_FLOAT(worldNormals[bestFace][0]);
+        float ny = FIXED3D_TO_FLOAT(worldNormals[bestFace][1]);
+        float nz = FIXED3D_TO_FLOAT(worldNormals[bestFace][2]);
+
+        // Rotation axis between face normal and gravity
+        float crossX = ny * gravityZ - nz * gravityY;
+        float crossY = nz * gravityX - nx * gravityZ;
+        float crossZ = nx * gravityY - ny * gravityX;
+        float crossLength = FastMath_Sqrt(crossX * crossX + crossY * crossY + crossZ * crossZ);
+
+        if (crossLength > 0.001f) {
+            // The magnitude of rotation is proportional to the misalignment
+            float scale = FastMath_Acos(-bestAlignment) * STABILIZATION_STRENGTH / crossLength;
+
+            *torqueX = crossX * scale;
+            *torqueY = crossY * scale;
+            *torqueZ = crossZ * scale;
+        }
+    }
+}
+
+// Keep every corner inside the box and bounce off the walls it crossed
+static void ResolveWalls(int b)
+{
+    fixed_t rotated[NUM_CORNERS][3];
+    float normal[3] = {0.0f, 0.0f, 0.0f};
+    float* pos[3];
+    bool collisionDetected = false;
+    int i, axis;
+
+    pos[0] = &g_posX[b];
+    pos[1] = &g_posY[b];
+    pos[2] = &g_posZ[b];
+
+    Fixed3D_TransformPoints(&g_rotation[b], g_corners, rotated, NUM_CORNERS);
+
+    for (i = 0; i < NUM_CORNERS; i++) {
+        for (axis = 0; axis < 3; axis++) {
+            float world = *pos[axis] + FIXED3D_TO_FLOAT(rotated[i][axis]);
+
+            // Push the cube back inside and note which way the wall faces
+            if (world < g_boxMin[axis]) {
+                collisionDetected = true;
+                normal[axis] += 1.0f;
+                *pos[axis] += g_boxMin[axis] - world;
+            } else if (world > g_boxMax[axis]) {
+                collisionDetected = true;
+                normal[axis] -= 1.0f;
+                *pos[axis] -= world - g_boxMax[axis];
+            }
+        }
+    }
+
+    if (collisionDetected) {
+        // Normalize the collision normal (could be from multiple corners)
+        float lengthSq = normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2];
+
+        if (lengthSq > 0.000001f) {
+            float inv = FastMath_InvSqrt(lengthSq);
+            float nx = normal[0] * inv;
+            float ny = normal[1] * inv;
+            float nz = normal[2] * inv;
+            float dotProduct = g_velX[b] * nx + g_velY[b] * ny + g_velZ[b] * nz;
+
+            // Reflect velocity based on collision normal
+            if (dotProduct < 0) {
+                g_velX[b] -= (1.0f + RESTITUTION) * dotProduct * nx;
+                g_velY[b] -= (1.0f + RESTITUTION) * dotProduct * ny;
+                g_velZ[b] -= (1.0f + RESTITUTION) * dotProduct * nz;
+
+                // A little spin on impact
+                g_angVelX[b] += (rand() % 100) / 1000.0f - 0.05f;
+                g_angVelY[b] += (rand() % 100) / 1000.0f - 0.05f;
+                g_angVelZ[b] += (rand() % 100) / 1000.0f - 0.05f;
+            }
+        }
+    }
+}
+
+//*****************************************************************************
+// Cube-cube contacts
+//*****************************************************************************
+
+// Separate an overlapping pair and exchange the impulse along the normal
+static void ResolvePair(int a, int b)
+{
+    float dx = g_posX[b] - g_posX[a];
+    float dy = g_posY[b] - g_posY[a];
+    float dz = g_posZ[b] - g_posZ[a];
+    float distSq = dx * dx + dy * dy + dz * dz;
+    float minDist = 2.0f * g_contactRadius;
+    float inv, dist, push, relVel;
+
+    if (distSq >= minDist * minDist) {
+        return;
+    }
+
+    if (distSq < 0.000001f) {
+        // Coincident centers: pick an axis
+        dx = 1.0f;
+        dy = 0.0f;
+        dz = 0.0f;
+        dist = 0.0f;
+    } else {
+        inv = FastMath_InvSqrt(distSq);
+        dist = distSq * inv;
+        dx *= inv;
+        dy *= inv;
+        dz *= inv;
+    }
+
+    // Each body takes half of the overlap
+    push = 0.5f * (minDist - dist);
+    g_posX[a] -= dx * push;
+    g_posY[a] -= dy * push;
+    g_posZ[a] -= dz * push;
+    g_posX[b] += dx * push;
+    g_posY[b] += dy * push;
+    g_posZ[b] += dz * push;
+
+    relVel = (g_velX[b] - g_velX[a]) * dx +
+             (g_velY[b] - g_velY[a]) * dy +
+             (g_velZ[b] - g_velZ[a]) * dz;
+    if (relVel < 0.0f) {
+        float impulse = 0.5f * (1.0f + RESTITUTION) * relVel;
+
+        g_velX[a] += impulse * dx;
+        g_velY[a] += impulse * dy;
+        g_velZ[a] += impulse * dz;
+        g_velX[b] -= impulse * dx;
+        g_velY[b] -= impulse * dy;
+        g_velZ[b] -= impulse * dz;
+    }
+}
+
+// Sort-and-sweep on X: only pairs whose X intervals overlap reach the
+// narrowphase. Insertion sort is near O(N) since the order barely changes.
+static void ResolveContacts(void)
+{
+    int i, j;
+
+    for (i = 1; i < g_bodyCount; i++) {
+        uint8_t body = g_sortedX[i];
+        float key = g_posX[body];
+
+        for (j = i - 1; j >= 0 && g_posX[g_sortedX[j]] > key; j--) {
+            g_sortedX[j + 1] = g_sortedX[j];
+        }
+        g_sortedX[j + 1] = body;
+    }
+
+    for (i = 0; i < g_bodyCount; i++) {
+        int a = g_sortedX[i];
+        float maxX = g_posX[a] + 2.0f * g_boundRadius;
+
+        for (j = i + 1; j < g_bodyCount; j++) {
+            int b = g_sortedX[j];
+
+            if (g_posX[b] > maxX) {
+                break;      // every later body starts further right
+            }
+            ResolvePair(a, b);
+        }
+    }
+}
+
+//*****************************************************************************
+// Public API
+//*****************************************************************************
+void PhysicsWorld_Init(float halfSize, const float boxMin[3], const float boxMax[3])
+{
+    fixed_t h = FIXED3D_FROM_FLOAT(halfSize);
+    int i;
+
+    g_bodyCount = 0;
+    g_boundRadius = halfSize * 1.7320508f;
+    g_contactRadius = halfSize * PHYSICS_CONTACT_SCALE;
+
+    for (i = 0; i < 3; i++) {
+        g_boxMin[i] = boxMin[i];
+        g_boxMax[i] = boxMax[i];
+    }
+
+    for (i = 0; i < NUM_CORNERS; i++) {
+        g_corners[i][0] = (i & 1) ? h : -h;
+        g_corners[i][1] = (i & 2) ? h : -h;
+        g_corners[i][2] = (i & 4) ? h : -h;
+    }
+}
+
+int PhysicsWorld_AddBody(float x, float y, float z)
+{
+    int b = g_bodyCount;
+
+    if (b >= PHYSICS_MAX_BODIES) {
+        return -1;
+    }
+
+    g_posX[b] = x;
+    g_posY[b] = y;
+    g_posZ[b] = z;
+    g_velX[b] = 0.0f;
+    g_velY[b] = 0.0f;
+    g_velZ[b] = 0.0f;
+    g_angVelX[b] = 0.0f;
+    g_angVelY[b] = 0.0f;
+    g_angVelZ[b] = 0.0f;
+    Fixed3D_QuatIdentity(&g_orientation[b]);
+    Fixed3D_FromQuaternion(&g_rotation[b], &g_orientation[b]);
+    g_sortedX[b] = (uint8_t)b;
+
+    g_bodyCount++;
+    return b;
+}
+
+int PhysicsWorld_GetBodyCount(void)
+{
+    return g_bodyCount;
+}
+
+void PhysicsWorld_Step(float gravityX, float gravityY, float gravityZ)
+{
+    bool hasGravity = (gravityX != 0.0f || gravityY != 0.0f || gravityZ != 0.0f);
+    int b;
+
+    for (b = 0; b < g_bodyCount; b++) {
+        if (hasGravity) {
+            float torqueX, torqueY, torqueZ;
+
+            // Apply gravity to velocity (scaled by gravity strength)
+            g_velX[b] += gravityX * GRAVITY_STRENGTH * TIME_STEP;
+            g_velY[b] += gravityY * GRAVITY_STRENGTH * TIME_STEP;
+            g_velZ[b] += gravityZ * GRAVITY_STRENGTH * TIME_STEP;
+
+            // Stabilizing torque to settle the cube onto a face
+            StabilizingTorque(b, gravityX, gravityY, gravityZ, &torqueX, &torqueY, &torqueZ);
+            g_angVelX[b] += torqueX;
+            g_angVelY[b] += torqueY;
+            g_angVelZ[b] += torqueZ;
+        }
+
+        // Damping (simulates air resistance/friction), then integrate position
+        g_velX[b] *= DAMPING;
+        g_velY[b] *= DAMPING;
+        g_velZ[b] *= DAMPING;
+        g_posX[b] += g_velX[b] * TIME_STEP;
+        g_posY[b] += g_velY[b] * TIME_STEP;
+        g_posZ[b] += g_velZ[b] * TIME_STEP;
+
+        // Same for the orientation; the matrix is rebuilt once here
+        g_angVelX[b] *= ANGULAR_DAMPING;
+        g_angVelY[b] *= ANGULAR_DAMPING;
+        g_angVelZ[b] *= ANGULAR_DAMPING;
+        Fixed3D_QuatIntegrate(&g_orientation[b], g_angVelX[b], g_angVelY[b], g_angVelZ[b], TIME_STEP);
+        Fixed3D_FromQuaternion(&g_rotation[b], &g_orientation[b]);
+
+        ResolveWalls(b);
+    }
+
+    if (g_bodyCount > 1) {
+        ResolveContacts();
+
+        // A contact can push a body back through a wall
+        for (b = 0; b < g_bodyCount; b++) {
+            ResolveWalls(b);
+        }
+    }
+}
+
+void PhysicsWorld_GetPosition(int body, float *x, float *y, float *z)
+{
+    *x = g_posX[body];
+    *y = g_posY[body];
+    *z = g_posZ[body];
+}
+
+const Fixed3D_Matrix* PhysicsWorld_GetRotation(int body)
+{
+    return &g_rotation[body];
+}
+
+#if PHYSICS_WORLD_BENCHMARK
+//*****************************************************************************
+// Benchmark
+// Bodies start on a grid inside the box and fall for a few steps first so
+// the timed steps include wall and cube contacts. SysTick counts down at
+// 80MHz; one step of 16 bodies stays well inside its 24-bit range.
+//*****************************************************************************
+#define BENCH_WARMUP_STEPS      20
+#define BENCH_STEPS             16
+
+void PhysicsWorld_Benchmark(void)
+{
+    float boxMin[3] = {-60.0f, -60.0f, 0.0f};
+    float boxMax[3] = {60.0f, 60.0f, 120.0f};
+    unsigned long ticks;
+    int n, i, step;
+
+    SysTickDisable();
+    SysTickIntDisable();
+    SysTickPeriodSet(0xFFFFFF);
+    SysTickEnable();
+
+    for (n = 1; n <= PHYSICS_MAX_BODIES; n *= 2) {
+        PhysicsWorld_Init(15.0f, boxMin, boxMax);
+        for (i = 0; i < n; i++) {
+            PhysicsWorld_AddBody(-40.0f + 27.0f * (i % 4), -40.0f + 27.0f * ((i / 4) % 4), 60.0f);
+        }
+        for (step = 0; step < BENCH_WARMUP_STEPS; step++) {
+            PhysicsWorld_Step(0.3f, -0.9f, 0.3f);
+        }
+
+        ticks = 0;
+        for (step = 0; step < BENCH_STEPS; step++) {
+            unsigned long start = SysTickValueGet();
+            PhysicsWorld_Step(0.3f, -0.9f, 0.3f);
+            ticks += (start - SysTickValueGet()) & 0xFFFFFF;
+        }
+
+        Report("%2d bodies: %lu cycles/step (%lu us)\n\r", n, ticks / BENCH_STEPS,
+               ticks / BENCH_STEPS / 80);
+    }
+
+    PhysicsWorld_Init(15.0f, boxMin, boxMax);
+}
+#endif // PHYSICS_WORLD_BENCHMARK
@@ -0,0 +1,67 @@
+//*****************************************************************************
+// Physics World
+// A fixed pool of cubes bouncing around inside an axis-aligned box. Body
+// state is kept as struct-of-arrays so each pass of the step touches only
+// the fields it needs. Every step applies gravity and the face-down
+// stabilizing torque, integrates position and orientation, resolves wall
+// contacts per corner, then finds cube-cube contacts with a sort-and-sweep
+// broadphase on X and a sphere narrowphase.
+//*****************************************************************************
+
+#ifndef PHYSICS_WORLD_H_
+#define PHYSICS_WORLD_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "fixed3d.h"
+
+// Size of the body pool
+#ifndef PHYSICS_MAX_BODIES
+#define PHYSICS_MAX_BODIES      16
+#endif
+
+// Cube-cube contacts treat each cube as a sphere of this many half-sizes:
+// between the inscribed (1.0) and circumscribed (1.73) spheres
+#define PHYSICS_CONTACT_SCALE   1.2f
+
+// Set to 1 to build PhysicsWorld_Benchmark()
+#ifndef PHYSICS_WORLD_BENCHMARK
+#define PHYSICS_WORLD_BENCHMARK 0
+#endif
+
+//*****************************************************************************
+// Empty the pool and set the world up. halfSize is the cube half-extent,
+// boxMin/boxMax the walls (x, y, z) every corner is kept inside.
+//*****************************************************************************
+void PhysicsWorld_Init(float halfSize, const float boxMin[3], const float boxMax[3]);
+
+//*****************************************************************************
+// Add a cube at rest, unrotated, centered on (x, y, z). Returns its index,
+// or -1 when the pool is full.
+//*****************************************************************************
+int PhysicsWorld_AddBody(float x, float y, float z);
+
+int PhysicsWorld_GetBodyCount(void);
+
+//*****************************************************************************
+// Advance the world one step. (gravityX, gravityY, gravityZ) is the unit
+// gravity direction, or all zero when there is no usable reading.
+//*****************************************************************************
+void PhysicsWorld_Step(float gravityX, float gravityY, float gravityZ);
+
+//*****************************************************************************
+// Body state for rendering
+//*****************************************************************************
+void PhysicsWorld_GetPosition(int body, float *x, float *y, float *z);
+const Fixed3D_Matrix* PhysicsWorld_GetRotation(int body);
+
+#if PHYSICS_WORLD_BENCHMARK
+//*****************************************************************************
+// Time PhysicsWorld_Step() with SysTick for 1, 2, 4, 8 and 16 bodies and
+// print the cost per step over UART. Leaves the world empty.
+//*****************************************************************************
+void PhysicsWorld_Benchmark(void);
+#endif
+
+#endif /* PHYSICS_WORLD_H_ */
@@ -0,0 +1,134 @@
+//*****************************************************************************
+// Pixel Batch
+// See pixel_batch.h for an overview.
+//
+// Each queued write is stored as a sort key (row, column, sequence number)
+// plus its color, indexed by sequence number. Sorting the keys groups
+// writes to the same pixel together in the order they were made, so the
+// last one in each group is the color that would have ended up on screen.
+//*****************************************************************************
+
+// Standard includes
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "Adafruit_SSD1351.h"
+#include "pixel_batch.h"
+
+#define KEY(x, y, seq)      (((uint32_t)(y) << 24) | ((uint32_t)(x) << 16) | (seq))
+#define KEY_X(key)          (((key) >> 16) & 0xFF)
+#define KEY_Y(key)          ((key) >> 24)
+#define KEY_SEQ(key)        ((key) & 0xFFFF)
+
+//*****************************************************************************
+// Global Variables
+//*****************************************************************************
+static uint32_t g_batchKeys[PIXEL_BATCH_CAPACITY];
+static uint16_t g_batchColors[PIXEL_BATCH_CAPACITY];
+static uint16_t g_runBuffer[SSD1351WIDTH];
+static int g_batchCount = 0;
+static bool g_batchActive = false;
+static bool g_batchFlushing = false;
+
+//*****************************************************************************
+// Helpers
+//*****************************************************************************
+
+// Shell sort, keys are unique so the result is fully ordered
+static void SortKeys(uint32_t *keys, int n)
+{
+    int gap, i, j;
+
+    for (gap = n / 2; gap > 0; gap /= 2) {
+        for (i = gap; i < n; i++) {
+            uint32_t key = keys[i];
+            for (j = i; j >= gap && keys[j - gap] > key; j -= gap) {
+                keys[j] = keys[j - gap];
+            }
+            keys[j] = key;
+        }
+    }
+}
+
+static void SendRun(int x, int y, int length)
+{
+    beginWindow(x, y, length, 1);
+    pushPixels(g_runBuffer, length);
+    endWindow();
+}
+
+//*****************************************************************************
+// Public API
+//*****************************************************************************
+void PixelBatch_Begin(void)
+{
+    g_batchActive = true;
+}
+
+void PixelBatch_End(void)
+{
+    PixelBatch_Flush();
+    g_batchActive = false;
+}
+
+bool PixelBatch_IsActive(void)
+{
+    return g_batchActive;
+}
+
+void PixelBatch_Add(int x, int y, uint16_t color)
+{
+    if ((x < 0) || (y < 0) || (x >= SSD1351WIDTH) || (y >= SSD1351HEIGHT)) {
+        return;
+    }
+
+    if (g_batchCount == PIXEL_BATCH_CAPACITY) {
+        PixelBatch_Flush();
+    }
+
+    g_batchKeys[g_batchCount] = KEY(x, y, g_batchCount);
+    g_batchColors[g_batchCount] = color;
+    g_batchCount++;
+}
+
+void PixelBatch_Flush(void)
+{
+    int i;
+    int runX = 0, runY = 0, runLength = 0;
+
+    // beginWindow() calls back in here, ignore it while we are sending
+    if (g_batchFlushing || g_batchCount == 0) {
+        return;
+    }
+    g_batchFlushing = true;
+
+    SortKeys(g_batchKeys, g_batchCount);
+
+    for (i = 0; i < g_batchCount; i++) {
+        uint32_t key = g_batchKeys[i];
+        int x = KEY_X(key);
+        int y = KEY_Y(key);
+
+        // Only the last write to a pixel matters
+        if ((i + 1 < g_batchCount) && ((g_batchKeys[i + 1] >> 16) == (key >> 16))) {
+            continue;
+        }
+
+        if (runLength > 0 && (y != runY || x != runX + runLength)) {
+            SendRun(runX, runY, runLength);
+            runLength = 0;
+        }
+        if (runLength == 0) {
+            runX = x;
+            runY = y;
+        }
+        g_runBuffer[runLength++] = g_batchColors[KEY_SEQ(key)];
+    }
+
+    if (runLength > 0) {
+        SendRun(runX, runY, runLength);
+    }
+
+    g_batchCount = 0;
+    g_batchFlushing = false;
+}
@@ -0,0 +1,46 @@
+//*****************************************************************************
+// Pixel Batch
+// Opt-in coalescer for single-pixel drawing. While a batch is open,
+// drawPixel() queues its writes here instead of opening a one-pixel window
+// each. A flush sorts the queue by row and column, keeps only the last color
+// written to each pixel (so an erase followed by a redraw of the same pixel
+// costs one write), and sends every horizontal run as a single window.
+//*****************************************************************************
+
+#ifndef PIXEL_BATCH_H_
+#define PIXEL_BATCH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Queued pixel writes before the batch flushes itself
+#define PIXEL_BATCH_CAPACITY    1024
+
+//*****************************************************************************
+// Open a batch. Subsequent drawPixel() calls are queued until
+// PixelBatch_End(), an explicit flush, or the queue filling up.
+//*****************************************************************************
+void PixelBatch_Begin(void);
+
+//*****************************************************************************
+// Flush whatever is queued and return drawPixel() to direct drawing
+//*****************************************************************************
+void PixelBatch_End(void);
+
+//*****************************************************************************
+// Send the queued pixels now. Every other drawing primitive calls this
+// before touching the panel, so queued pixels are never drawn out of order.
+//*****************************************************************************
+void PixelBatch_Flush(void);
+
+//*****************************************************************************
+// Returns true while a batch is open
+//*****************************************************************************
+bool PixelBatch_IsActive(void);
+
+//*****************************************************************************
+// Queue one pixel (used by drawPixel(), coordinates are not yet clipped)
+//*****************************************************************************
+void PixelBatch_Add(int x, int y, uint16_t color);
+
+#endif /* PIXEL_BATCH_H_ */
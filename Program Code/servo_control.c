@@ -5,7 +5,6 @@
 //*****************************************************************************
 
 #include <shared_defs.h>
-#include <math.h>
 
 // Driverlib includes
 #include "hw_types.h"
@@ -26,6 +25,9 @@
 
 #include "Adafruit_GFX.h"
 #include "Adafruit_SSD1351.h"
+#include "pixel_batch.h"
+#include "fixed3d.h"
+#include "fast_math.h"
 
 // Digital Servo Settings
 #define SERVO_FREQ_HZ 300       // 300Hz for digital servo (instead of 50Hz)
@@ -51,35 +53,43 @@
 
 #define NUM_VERTICES            16    // Two rectangular prisms = 16 vertices
 #define NUM_EDGES               24    // Two rectangular prisms = 24 edges
+#define NUM_BASE_VERTICES       8     // Vertices 0-7 are the base, 8-15 the arm
+
+// Perspective projection: focal length and camera distance
+#define FOCAL_LENGTH            100
+#define CAMERA_Z_OFFSET         80
 
 // Application state variables
 static int g_servo1Angle = 90;  // Current angle for servo 1 (0-180)
 static int g_servo2Angle = 90;  // Current angle for servo 2 (0-180)
 static bool g_initialized = false; // Initialization flag
 
-// 3D Rectangular Prism vertices (x, y, z) - representing servo base and arm
-float g_arm_vertices[NUM_VERTICES][3] = {
+// Integer vertex coordinate to Q16.16
+#define FX(v)                   FIXED3D_FROM_INT(v)
+
+// 3D Rectangular Prism vertices (x, y, z), Q16.16 - representing servo base and arm
+fixed_t g_arm_vertices[NUM_VERTICES][3] = {
     // First rectangle (base) - Bottom vertices (Y = -ARM_HEIGHT/2)
-    {-ARM_LENGTH/2, -ARM_HEIGHT/2, -ARM_DEPTH/2},   // 0: bottom back left
-    {ARM_LENGTH/2, -ARM_HEIGHT/2, -ARM_DEPTH/2},    // 1: bottom back right
-    {ARM_LENGTH/2, -ARM_HEIGHT/2, ARM_DEPTH/2},     // 2: bottom front right
-    {-ARM_LENGTH/2, -ARM_HEIGHT/2, ARM_DEPTH/2},    // 3: bottom front left
+    {FX(-ARM_LENGTH/2), FX(-ARM_HEIGHT/2), FX(-ARM_DEPTH/2)},   // 0: bottom back left
+    {FX(ARM_LENGTH/2), FX(-ARM_HEIGHT/2), FX(-ARM_DEPTH/2)},    // 1: bottom back right
+    {FX(ARM_LENGTH/2), FX(-ARM_HEIGHT/2), FX(ARM_DEPTH/2)},     // 2: bottom front right
+    {FX(-ARM_LENGTH/2), FX(-ARM_HEIGHT/2), FX(ARM_DEPTH/2)},    // 3: bottom front left
     // First rectangle (base) - Top vertices (Y = +ARM_HEIGHT/2)
-    {-ARM_LENGTH/2, ARM_HEIGHT/2, -ARM_DEPTH/2},    // 4: top back left
-    {ARM_LENGTH/2, ARM_HEIGHT/2, -ARM_DEPTH/2},     // 5: top back right
-    {ARM_LENGTH/2, ARM_HEIGHT/2, ARM_DEPTH/2},      // 6: top front right
-    {-ARM_LENGTH/2, ARM_HEIGHT/2, ARM_DEPTH/2},     // 7: top front left
+    {FX(-ARM_LENGTH/2), FX(ARM_HEIGHT/2), FX(-ARM_DEPTH/2)},    // 4: top back left
+    {FX(ARM_LENGTH/2), FX(ARM_HEIGHT/2), FX(-ARM_DEPTH/2)},     // 5: top back right
+    {FX(ARM_LENGTH/2), FX(ARM_HEIGHT/2), FX(ARM_DEPTH/2)},      // 6: top front right
+    {FX(-ARM_LENGTH/2), FX(ARM_HEIGHT/2), FX(ARM_DEPTH/2)},     // 7: top front left
 
     // Second rectangle (arm) - Bottom vertices (attached to right end of first)
-    {4, 25, -3},   // 8: arm bottom back left (at attachment point)
-    {34, 25, -3},  // 9: arm bottom back right
-    {34, 25, 3},   // 10: arm bottom front right
-    {4, 25, 3},    // 11: arm bottom front left (at attachment point)
+    {FX(4), FX(25), FX(-3)},   // 8: arm bottom back left (at attachment point)
+    {FX(34), FX(25), FX(-3)},  // 9: arm bottom back right
+    {FX(34), FX(25), FX(3)},   // 10: arm bottom front right
+    {FX(4), FX(25), FX(3)},    // 11: arm bottom front left (at attachment point)
     // Second rectangle (arm) - Top vertices
-    {4, 31, -3},   // 12: arm top back left (at attachment point)
-    {34, 31, -3},  // 13: arm top back right
-    {34, 31, 3},   // 14: arm top front right
-    {4, 31, 3}     // 15: arm top front left (at attachment point)
+    {FX(4), FX(31), FX(-3)},   // 12: arm top back left (at attachment point)
+    {FX(34), FX(31), FX(-3)},  // 13: arm top back right
+    {FX(34), FX(31), FX(3)},   // 14: arm top front right
+    {FX(4), FX(31), FX(3)}     // 15: arm top front left (at attachment point)
 };
 
 // Rectangular prism edges defined as pairs of vertex indices
@@ -118,8 +128,8 @@ static void ReadADCChannel(unsigned int uiChannel, float *voltageResult);
 static bool ShouldExit(void);
 
 // 3D visualization functions
-static void RotatePoint(float x, float y, float z, float* rx, float* ry, float* rz, int vertexIndex);
-static void ProjectPoint(float x, float y, float z, int* px, int* py);
+static void BuildArmTransforms(Fixed3D_Matrix* base, Fixed3D_Matrix* arm);
+static void ProjectPoint(fixed_t x, fixed_t y, fixed_t z, int* px, int* py);
 static void RenderServoArm(uint16_t color);
 static void InitializeDisplay(void);
 
@@ -128,10 +138,12 @@ static void InitializeDisplay(void);
 //*****************************************************************************
 void ServoControl_Initialize(void)
 {
+    // Reciprocal table for the perspective divide
+    Fixed3D_Init();
 
     // Initialize visualization angles
-    g_visualAngle1 = ((float)g_servo1Angle * M_PI) / 180.0f;
-    g_visualAngle2 = ((float)(g_servo2Angle - 90) * M_PI) / 180.0f;
+    g_visualAngle1 = ((float)g_servo1Angle * FAST_MATH_PI) / 180.0f;
+    g_visualAngle2 = ((float)(g_servo2Angle - 90) * FAST_MATH_PI) / 180.0f;
 
     // Configure and enable timers for servo control
     ConfigTimersForServos();
@@ -167,58 +179,42 @@ static void InitializeDisplay(void)
 }
 
 //*****************************************************************************
-// Apply rotations to a 3D point based on which part it belongs to
+// Build this frame's transforms for the base and the arm
 //*****************************************************************************
-static void RotatePoint(float x, float y, float z, float* rx, float* ry, float* rz, int vertexIndex)
+static void BuildArmTransforms(Fixed3D_Matrix* base, Fixed3D_Matrix* arm)
 {
-    float temp_x = x, temp_y = y, temp_z = z;
-
-    // If this is a vertex from the second rectangle (arm), apply servo 2 rotation first
-    if (vertexIndex >= 8) {
-        // The arm rotates around its long edge (Z-axis) at the attachment point
-        // Translate so rotation point is at the attachment edge (Y = ARM_HEIGHT/2)
-        temp_y -= ARM_HEIGHT/2;
-
-        // Apply Z-axis rotation (servo 2) - arm bends down/up around its long edge
-        float rot_x = temp_x * cosf(g_visualAngle2) - temp_y * sinf(g_visualAngle2);
-        float rot_y = temp_x * sinf(g_visualAngle2) + temp_y * cosf(g_visualAngle2);
-
-        temp_x = rot_x;
-        temp_y = rot_y;
-
-        // Translate back
-        temp_y += ARM_HEIGHT/2;
-    }
-
-    // Apply Y-axis rotation (servo 1) to all vertices - base rotation
-    float final_x = temp_x * cosf(g_visualAngle1/2) + temp_z * sinf(g_visualAngle1/4);
-    float final_y = temp_y; // No change in Y for Y-axis rotation
-    float final_z = -temp_x * sinf(g_visualAngle1/4) + temp_z * cosf(g_visualAngle1/4);
-
-    *rx = final_x;
-    *ry = final_y;
-    *rz = final_z;
+    Fixed3D_Matrix bend;
+    float c, s;
+
+    // Y-axis rotation (servo 1) applied to all vertices - base rotation
+    FastMath_SinCos(g_visualAngle1/4, &s, &c);
+    Fixed3D_Identity(base);
+    base->m[0][0] = FIXED3D_FROM_FLOAT(FastMath_Cos(g_visualAngle1/2));
+    base->m[0][2] = FIXED3D_FROM_FLOAT(s);
+    base->m[2][0] = -FIXED3D_FROM_FLOAT(s);
+    base->m[2][2] = FIXED3D_FROM_FLOAT(c);
+
+    // The arm rotates around its long edge (Z-axis) at the attachment point
+    // (Y = ARM_HEIGHT/2) first (servo 2) - arm bends down/up around its long edge
+    FastMath_SinCos(g_visualAngle2, &s, &c);
+    Fixed3D_Identity(&bend);
+    bend.m[0][0] = FIXED3D_FROM_FLOAT(c);
+    bend.m[0][1] = FIXED3D_FROM_FLOAT(-s);
+    bend.m[1][0] = FIXED3D_FROM_FLOAT(s);
+    bend.m[1][1] = FIXED3D_FROM_FLOAT(c);
+    bend.t[0] = FIXED3D_FROM_FLOAT(s * (ARM_HEIGHT/2));
+    bend.t[1] = FIXED3D_FROM_FLOAT((1.0f - c) * (ARM_HEIGHT/2));
+
+    Fixed3D_Multiply(arm, base, &bend);
 }
 
 //*****************************************************************************
 // Project a 3D point to 2D screen space using perspective projection
 //*****************************************************************************
-static void ProjectPoint(float x, float y, float z, int* px, int* py)
+static void ProjectPoint(fixed_t x, fixed_t y, fixed_t z, int* px, int* py)
 {
-    // Perspective projection parameters
-    float f = 100.0f;        // Focal length
-    float z_offset = 80.0f;  // Camera distance from object
-
-    // Apply perspective projection
-    if (fabsf(z + z_offset) > 0.001f) {
-        float perspective = f / (z + z_offset);
-        *px = SCREEN_CENTER_X + (int)(x * perspective);
-        *py = SCREEN_CENTER_Y - (int)(y * perspective);  // Y is inverted in screen space
-    } else {
-        // Fallback for points at camera position
-        *px = SCREEN_CENTER_X + (int)x;
-        *py = SCREEN_CENTER_Y - (int)y;
-    }
+    Fixed3D_Project(x, y, z, FOCAL_LENGTH, CAMERA_Z_OFFSET,
+                    SCREEN_CENTER_X, SCREEN_CENTER_Y, px, py);
 
     // Clamp to screen boundaries
     if (*px < 0) *px = 0;
@@ -233,24 +229,26 @@ static void ProjectPoint(float x, float y, float z, int* px, int* py)
 static void RenderServoArm(uint16_t color)
 {
     int i;
-    float rx, ry, rz;
+    Fixed3D_Matrix base, arm;
+    fixed_t rotated[NUM_VERTICES][3];
+
+    // Rotate the base and arm vertices with this frame's matrices
+    BuildArmTransforms(&base, &arm);
+    Fixed3D_TransformPoints(&base, g_arm_vertices, rotated, NUM_BASE_VERTICES);
+    Fixed3D_TransformPoints(&arm, &g_arm_vertices[NUM_BASE_VERTICES], &rotated[NUM_BASE_VERTICES],
+                            NUM_VERTICES - NUM_BASE_VERTICES);
 
     // Calculate projected vertices for current frame
     for (i = 0; i < NUM_VERTICES; i++) {
-        // Apply rotation
-        RotatePoint(
-            g_arm_vertices[i][0],
-            g_arm_vertices[i][1],
-            g_arm_vertices[i][2],
-            &rx, &ry, &rz, i
-        );
-
         // Project to 2D
-        ProjectPoint(rx, ry, rz,
+        ProjectPoint(rotated[i][0], rotated[i][1], rotated[i][2],
                     &g_projected_vertices[i][0],
                     &g_projected_vertices[i][1]);
     }
 
+    // Batch the erase and redraw so pixels covered by both are sent once
+    PixelBatch_Begin();
+
     // If not the first frame, erase the previous frame by drawing black lines
     if (!first_frame) {
         // Draw black lines over previous edges
@@ -283,6 +281,8 @@ static void RenderServoArm(uint16_t color)
     // Draw a small circle at the center to show rotation axis
     drawCircle(SCREEN_CENTER_X, SCREEN_CENTER_Y, 2, color);
 
+    PixelBatch_End();
+
     // Copy current vertices to previous vertices for the next frame
     for (i = 0; i < NUM_VERTICES; i++) {
         g_prev_projected_vertices[i][0] = g_projected_vertices[i][0];
@@ -377,7 +377,7 @@ static void SetServo1Angle(int angle)
 
     // Update visualization angle (convert servo angle to radians)
     // Maps servo angle directly to visual rotation around Y-axis
-    g_visualAngle1 = (180+1*(float)(angle) * M_PI) / 180.0f;
+    g_visualAngle1 = (180+1*(float)(angle) * FAST_MATH_PI) / 180.0f;
 
 }
 
@@ -408,7 +408,7 @@ static void SetServo2Angle(int angle)
 
     // Update visualization angle for second servo (convert servo angle to radians)
     // Maps servo 2 angle to arm rotation around X-axis (subtract 90 to center at 0)
-    g_visualAngle2 = (-1*(float)(angle - 90) * M_PI) / 180.0f;
+    g_visualAngle2 = (-1*(float)(angle - 90) * FAST_MATH_PI) / 180.0f;
 }
 
 //*****************************************************************************
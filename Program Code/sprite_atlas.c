@@ -0,0 +1,105 @@
+//*****************************************************************************
+// Sprite Atlas
+// Generated by Helper Programs/bitmap_converter.py --atlas, do not edit.
+// See sprite_atlas.h.
+//*****************************************************************************
+
+#include <stdint.h>
+#include "sprite_atlas.h"
+
+const SpriteAtlasAsset g_spriteAtlasAssets[SPRITE_ATLAS_ASSET_COUNT] = {
+    { 1,  13,  17,  4,   34,   0},   // character_run_left
+    { 2,  13,  17,  4,   34,   4},   // character_run_right
+    { 3,  13,  17,  6,   34,   8},   // character_jump
+    { 4,  13,  17,  6,   34,  14},   // character_double_jump
+};
+
+const uint16_t g_spriteAtlasOffsets[SPRITE_ATLAS_FRAME_COUNT] = {
+    0, 34, 68, 102,   // character_run_left
+    136, 170, 204, 238,   // character_run_right
+    272, 306, 340, 374, 408, 442,   // character_jump
+    476, 510, 544, 578, 612, 646,   // character_double_jump
+};
+
+const uint8_t g_spriteAtlas[SPRITE_ATLAS_BYTES] = {
+    // character_run_left frame 0
+    0x00, 0x00, 0x08, 0x00, 0x16, 0x00, 0x12, 0x00, 0x12, 0x00, 0x0F, 0xE0,
+    0x63, 0x10, 0x3D, 0x10, 0x01, 0x08, 0x01, 0x00, 0x79, 0x00, 0x47, 0x08,
+    0x80, 0xF8, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // character_run_left frame 1
+    0x00, 0x00, 0x00, 0x00, 0x70, 0x00, 0x48, 0x00, 0x48, 0x00, 0x48, 0x00,
+    0x36, 0x00, 0x03, 0x80, 0x02, 0x80, 0x0E, 0x40, 0x03, 0x40, 0x03, 0x00,
+    0x03, 0x00, 0x0D, 0xF8, 0x10, 0x08, 0xA0, 0x00, 0x40, 0x00,
+    // character_run_left frame 2
+    0x00, 0x00, 0x00, 0x00, 0x70, 0x00, 0x48, 0x00, 0x48, 0x00, 0x28, 0x00,
+    0x38, 0x00, 0x04, 0x00, 0x06, 0x00, 0x07, 0x00, 0x1E, 0x00, 0x04, 0x00,
+    0x3A, 0x00, 0x21, 0x00, 0x11, 0x20, 0x11, 0xD0, 0x18, 0x00,
+    // character_run_left frame 3
+    0x00, 0x00, 0x06, 0x00, 0x09, 0x00, 0x09, 0x00, 0x0D, 0x00, 0x12, 0xE0,
+    0x11, 0xB0, 0x0E, 0x88, 0x00, 0x88, 0x00, 0x88, 0x3F, 0x00, 0x21, 0x00,
+    0xC6, 0x00, 0x48, 0x00, 0x06, 0x00, 0x01, 0x00, 0x03, 0x00,
+    // character_run_right frame 0
+    0x00, 0x00, 0x00, 0x80, 0x03, 0x40, 0x02, 0x40, 0x02, 0x40, 0x3F, 0x80,
+    0x46, 0x30, 0x45, 0xE0, 0x84, 0x00, 0x04, 0x00, 0x04, 0xF0, 0x87, 0x10,
+    0xF8, 0x08, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // character_run_right frame 1
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x70, 0x00, 0x90, 0x00, 0x90, 0x00, 0x90,
+    0x03, 0x60, 0x0E, 0x00, 0x0A, 0x00, 0x13, 0x80, 0x16, 0x00, 0x06, 0x00,
+    0x06, 0x00, 0xFD, 0x80, 0x80, 0x40, 0x00, 0x28, 0x00, 0x10,
+    // character_run_right frame 2
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x70, 0x00, 0x90, 0x00, 0x90, 0x00, 0xA0,
+    0x00, 0xE0, 0x01, 0x00, 0x03, 0x00, 0x07, 0x00, 0x03, 0xC0, 0x01, 0x00,
+    0x02, 0xE0, 0x04, 0x20, 0x24, 0x40, 0x5C, 0x40, 0x00, 0xC0,
+    // character_run_right frame 3
+    0x00, 0x00, 0x03, 0x00, 0x04, 0x80, 0x04, 0x80, 0x05, 0x80, 0x3A, 0x40,
+    0x6C, 0x40, 0x8B, 0x80, 0x88, 0x00, 0x88, 0x00, 0x07, 0xE0, 0x04, 0x20,
+    0x03, 0x18, 0x00, 0x90, 0x03, 0x00, 0x04, 0x00, 0x06, 0x00,
+    // character_jump frame 0
+    0x00, 0x00, 0x03, 0x00, 0x04, 0x80, 0x04, 0x80, 0x04, 0x80, 0x03, 0x00,
+    0x0E, 0x00, 0x0B, 0x80, 0x0A, 0x80, 0x0A, 0x80, 0x12, 0x80, 0x05, 0x00,
+    0x04, 0x80, 0x08, 0x80, 0x08, 0x80, 0x08, 0x80, 0x18, 0xC0,
+    // character_jump frame 1
+    0x00, 0x00, 0x00, 0xC0, 0x01, 0x60, 0x01, 0x20, 0x01, 0x20, 0x01, 0xC0,
+    0x0E, 0x00, 0x12, 0x00, 0x16, 0x00, 0x16, 0x00, 0x02, 0x00, 0x03, 0x00,
+    0x05, 0x80, 0x02, 0x40, 0x04, 0x80, 0x09, 0x00, 0x0D, 0x80,
+    // character_jump frame 2
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC0, 0x01, 0x20, 0x01, 0x20,
+    0x01, 0x20, 0x02, 0xC0, 0x1C, 0x00, 0x24, 0x00, 0x2C, 0x00, 0x2C, 0x00,
+    0x2B, 0x00, 0x04, 0xC0, 0x02, 0x80, 0x05, 0x00, 0x0C, 0x80,
+    // character_jump frame 3
+    0x00, 0x00, 0x06, 0x00, 0x09, 0x00, 0x09, 0x00, 0x09, 0x00, 0x06, 0x00,
+    0x04, 0x00, 0x1E, 0x00, 0x25, 0x00, 0x25, 0x00, 0x24, 0x80, 0x24, 0x00,
+    0x0A, 0x00, 0x0A, 0x00, 0x05, 0x00, 0x0A, 0x00, 0x0F, 0x00,
+    // character_jump frame 4
+    0x06, 0x00, 0x09, 0x00, 0x09, 0x00, 0x09, 0x00, 0x46, 0x40, 0x44, 0x80,
+    0x25, 0x00, 0x1E, 0x00, 0x04, 0x00, 0x04, 0x00, 0x04, 0x00, 0x0A, 0x00,
+    0x0A, 0x00, 0x0A, 0x00, 0x0A, 0x00, 0x0A, 0x00, 0x0D, 0x00,
+    // character_jump frame 5
+    0x06, 0x00, 0x09, 0x00, 0x09, 0x00, 0x09, 0x00, 0x46, 0x40, 0x44, 0x80,
+    0x25, 0x00, 0x1E, 0x00, 0x04, 0x00, 0x04, 0x00, 0x04, 0x00, 0x0A, 0x00,
+    0x0A, 0x00, 0x0A, 0x00, 0x0A, 0x00, 0x0A, 0x00, 0x0D, 0x00,
+    // character_double_jump frame 0
+    0x06, 0x00, 0x09, 0x00, 0x09, 0x00, 0x09, 0x00, 0x46, 0x40, 0x44, 0x80,
+    0x25, 0x00, 0x1E, 0x00, 0x04, 0x00, 0x04, 0x00, 0x04, 0x00, 0x0A, 0x00,
+    0x0A, 0x00, 0x0A, 0x00, 0x0A, 0x00, 0x0A, 0x00, 0x0D, 0x00,
+    // character_double_jump frame 1
+    0x00, 0x00, 0x03, 0x00, 0x04, 0x80, 0x04, 0x80, 0x04, 0x80, 0x0B, 0x00,
+    0x38, 0x00, 0x54, 0x00, 0x52, 0x00, 0x2E, 0x00, 0x12, 0x00, 0x24, 0x00,
+    0x48, 0x00, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // character_double_jump frame 2
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8C, 0x00, 0x52, 0x00,
+    0x2E, 0x00, 0x93, 0x00, 0x54, 0xE0, 0x39, 0x10, 0x01, 0x10, 0x00, 0xE0,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // character_double_jump frame 3
+    0x00, 0x00, 0x04, 0x80, 0x02, 0x40, 0x04, 0x80, 0x09, 0x00, 0x0E, 0x80,
+    0x09, 0x40, 0x05, 0x40, 0x03, 0x80, 0x1A, 0x00, 0x24, 0x00, 0x24, 0x00,
+    0x24, 0x00, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // character_double_jump frame 4
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x70, 0x00, 0x88, 0x00,
+    0x89, 0xC0, 0x72, 0xA8, 0x0C, 0x90, 0x07, 0x40, 0x04, 0xA8, 0x03, 0x10,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // character_double_jump frame 5
+    0x00, 0x00, 0x00, 0xC0, 0x01, 0x20, 0x01, 0x20, 0x01, 0x20, 0x02, 0xC0,
+    0x0E, 0x00, 0x15, 0x00, 0x14, 0x80, 0x0B, 0x80, 0x04, 0x80, 0x09, 0x00,
+    0x12, 0x00, 0x09, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
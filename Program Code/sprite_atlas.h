@@ -0,0 +1,51 @@
+//*****************************************************************************
+// Sprite Atlas
+// Generated by Helper Programs/bitmap_converter.py --atlas, do not edit.
+// Frames of the small sprites that are built into the application image,
+// back to back in g_spriteAtlas. Frame n of an asset starts at
+// g_spriteAtlasOffsets[firstFrame + n].
+//*****************************************************************************
+
+#ifndef SPRITE_ATLAS_H_
+#define SPRITE_ATLAS_H_
+
+#include <stdint.h>
+
+#define SPRITE_ATLAS_BYTES              680
+#define SPRITE_ATLAS_ASSET_COUNT        4
+#define SPRITE_ATLAS_FRAME_COUNT        20
+
+#define ATLAS_CHARACTER_RUN_LEFT_WIDTH          13
+#define ATLAS_CHARACTER_RUN_LEFT_HEIGHT         17
+#define ATLAS_CHARACTER_RUN_LEFT_FRAME_COUNT    4
+#define ATLAS_CHARACTER_RUN_LEFT_FIRST_FRAME    0
+
+#define ATLAS_CHARACTER_RUN_RIGHT_WIDTH         13
+#define ATLAS_CHARACTER_RUN_RIGHT_HEIGHT        17
+#define ATLAS_CHARACTER_RUN_RIGHT_FRAME_COUNT   4
+#define ATLAS_CHARACTER_RUN_RIGHT_FIRST_FRAME   4
+
+#define ATLAS_CHARACTER_JUMP_WIDTH              13
+#define ATLAS_CHARACTER_JUMP_HEIGHT             17
+#define ATLAS_CHARACTER_JUMP_FRAME_COUNT        6
+#define ATLAS_CHARACTER_JUMP_FIRST_FRAME        8
+
+#define ATLAS_CHARACTER_DOUBLE_JUMP_WIDTH       13
+#define ATLAS_CHARACTER_DOUBLE_JUMP_HEIGHT      17
+#define ATLAS_CHARACTER_DOUBLE_JUMP_FRAME_COUNT 6
+#define ATLAS_CHARACTER_DOUBLE_JUMP_FIRST_FRAME 14
+
+typedef struct {
+    uint16_t assetId;               // AssetId in asset_manager.h
+    uint16_t width;
+    uint16_t height;
+    uint16_t frameCount;
+    uint16_t frameSize;             // bytes per frame
+    uint16_t firstFrame;            // index into g_spriteAtlasOffsets
+} SpriteAtlasAsset;
+
+extern const uint8_t g_spriteAtlas[SPRITE_ATLAS_BYTES];
+extern const uint16_t g_spriteAtlasOffsets[SPRITE_ATLAS_FRAME_COUNT];
+extern const SpriteAtlasAsset g_spriteAtlasAssets[SPRITE_ATLAS_ASSET_COUNT];
+
+#endif /* SPRITE_ATLAS_H_ */
@@ -20,6 +20,12 @@
 #include "character_jump_bitmap.h"
 #include "character_double_jump_bitmap.h"
 #include "map_bitmap.h"
+#include "game_loop.h"
+#include "level_collision.h"
+
+#if VIDEO_GAME_COLLISION_BENCHMARK
+#include "systick.h"
+#endif
 
 // Display settings
 #define SCREEN_WIDTH            128
@@ -42,6 +48,11 @@
 #define HORIZONTAL_DAMPING      0.92f  // Horizontal velocity damping factor
 #define GROUND_LEVEL            (CIRCLE_RADIUS + 1) // Ground level
 
+// Fixed-timestep loop: physics rate, and how many steps a slow frame may
+// catch up before the rest are dropped
+#define PHYSICS_STEP_HZ         60
+#define MAX_STEPS_PER_FRAME     4
+
 // Button 2 pin for exit detection
 #define BUTTON2_PIN             0x20     // PIN_21
 #define BUTTON2_PORT            GPIOA1_BASE
@@ -67,6 +78,16 @@ static bool double_jump_available = true;
 static bool playing_double_jump_animation = false;
 static int g_currentMapFrame = 0;
 
+// Frame timing
+static GameLoop g_loop;
+static bool g_loopStarted = false;
+
+// Animation state the player was last drawn with, to erase the same bitmap
+static float g_prevPlayerVX = 0.0f;
+static float g_prevCharacterFrame = 0;
+static bool g_prevJumpAnimation = false;
+static bool g_prevDoubleJumpAnimation = false;
+
 
 
 //*****************************************************************************
@@ -120,157 +141,138 @@ static bool IsJumpButtonPressed(void)
 }
 
 //*****************************************************************************
-// Get current system time in milliseconds
+// Get current game time in milliseconds: the physics steps run so far, so
+// it advances at the same rate however long frames take
 //*****************************************************************************
 static unsigned long GetCurrentTimeMs(void)
 {
-    // Simplified - in a real application, you'd use a proper time source
-    static unsigned long counter = 0;
-    counter += 16; // Approximate milliseconds per frame at 60fps
-    return counter;
+    return GameLoop_TimeMs(&g_loop);
 }
 
 //*****************************************************************************
 // Bitmap Collision Detection
 //*****************************************************************************
 
-// Check if the player collides with any pixels in the bitmap
-static void CheckBitmapCollision(int bitmapX, int bitmapY, const uint8_t *bitmap,
-                                int width, int height, int pixelSize)
+// Player collision box, screen coordinates with y up
+typedef struct {
+    int left;
+    int right;
+    int bottom;
+    int top;
+    int width;
+    int height;
+    int offset;                 // character model sits this far above the box
+} PlayerBox;
+
+// Contacts found over the solid pixels near the player
+typedef struct {
+    bool top;
+    bool bottom;
+    bool left;
+    bool right;
+    int topY;
+    int bottomY;
+    int leftX;
+    int rightX;
+} CollisionHits;
+
+static void GetPlayerBox(PlayerBox *box)
 {
     // Convert floating point player position to integers for collision checking
     int playerX = (int)g_playerX;
     int playerY = (int)g_playerY;
-    int playerWidth = CHARACTER_RUN_LEFT_WIDTH;
-    int playerHeight = CHARACTER_RUN_LEFT_HEIGHT;
 
-    // Account for character model being positioned above the collision box
-    int collisionBoxOffset = playerHeight;
-    int collisionY = playerY - collisionBoxOffset;
+    box->width = CHARACTER_RUN_LEFT_WIDTH;
+    box->height = CHARACTER_RUN_LEFT_HEIGHT;
 
-    // Early exit if no bounding box intersection is possible
-    if (playerX + playerWidth < bitmapX || playerX > bitmapX + width * pixelSize ||
-        collisionY > bitmapY + height * pixelSize || collisionY + playerHeight < bitmapY) {
-        return;
-    }
-
-    // Calculate collision flags and positions
-    bool collideTop = false;
-    bool collideBottom = false;
-    bool collideLeft = false;
-    bool collideRight = false;
-    int topCollisionY = 0;
-    int bottomCollisionY = 0;
-    int leftCollisionX = 0;
-    int rightCollisionX = 0;
+    // Account for character model being positioned above the collision box
+    box->offset = box->height;
 
     // Get player's edges in screen coordinates with the offset applied
-    int playerBottom = collisionY;
-    int playerTop = collisionY + playerHeight;
-    int playerLeft = playerX;
-    int playerRight = playerX + playerWidth;
-
-    int byteWidth = (width + 7) / 8; // Bytes per row in bitmap
+    box->bottom = playerY - box->offset;
+    box->top = box->bottom + box->height;
+    box->left = playerX;
+    box->right = playerX + box->width;
+}
 
+// Test one solid pixel against the player box
+static void TestCollisionPixel(const PlayerBox *box, int pixelScreenX, int pixelScreenY,
+                               int pixelSize, CollisionHits *hits)
+{
     // Height threshold for horizontal collisions - pixels must extend this far above player's feet
-    int horizontalCollisionHeightThreshold = playerHeight / 3;
-
-    // Variable declarations outside of for loops
-    int j;
-    int i;
-    int byteIndex;
-    uint8_t bitMask;
-    int pixelScreenX;
-    int pixelScreenY;
-    int pixelTop;
-    int pixelBottom;
-
-    // Check bitmap pixels that might intersect with player
-    for (j = 0; j < height; j++) {
-        for (i = 0; i < width; i++) {
-            // Calculate byte index and bit mask using same logic as drawBitmap
-            byteIndex = j * byteWidth + i / 8;
-            bitMask = 0x80 >> (i & 7); // Start with leftmost bit
+    int horizontalCollisionHeightThreshold = box->height / 3;
+
+    // In our coordinate system, top is higher Y, bottom is lower Y
+    int pixelBottom = pixelScreenY;
+    int pixelTop = pixelScreenY + pixelSize;
+
+    // IMPROVED: Bottom collision detection with greater vertical tolerance
+    // Player landing on pixel or slightly above it (within 8 pixels)
+    if (g_playerVY <= 0 && // Player falling downward or stationary
+        box->bottom >= pixelTop - 8 && // Increased tolerance
+        box->bottom <= pixelTop + 5 && // Allow small overlap
+        box->right > pixelScreenX &&
+        box->left < pixelScreenX + pixelSize) {
+
+        hits->bottom = true;
+        if (pixelTop > hits->bottomY) {
+            hits->bottomY = pixelTop;
+        }
+    }
 
-            // If this bit is set (solid pixel)
-            if (bitmap[byteIndex] & bitMask) {
-                // Convert bitmap pixel to screen coordinates
-                pixelScreenX = bitmapX + i * pixelSize;
+    // Top collision (player hitting head on pixel)
+    else if (g_playerVY > 0 && // Moving upward
+             box->top >= pixelBottom &&
+             box->top <= pixelBottom + 5 &&
+             box->right > pixelScreenX &&
+             box->left < pixelScreenX + pixelSize) {
 
-                // Invert Y coordinate to match screen coordinates
-                pixelScreenY = bitmapY + (height - 1 - j) * pixelSize;
-
-                // In our coordinate system, top is higher Y, bottom is lower Y
-                pixelBottom = pixelScreenY;
-                pixelTop = pixelScreenY + pixelSize;
-
-                // IMPROVED: Bottom collision detection with greater vertical tolerance
-                // Player landing on pixel or slightly above it (within 8 pixels)
-                if (g_playerVY <= 0 && // Player falling downward or stationary
-                    playerBottom >= pixelTop - 8 && // Increased tolerance
-                    playerBottom <= pixelTop + 5 && // Allow small overlap
-                    playerRight > pixelScreenX &&
-                    playerLeft < pixelScreenX + pixelSize) {
-
-                    collideBottom = true;
-                    if (pixelTop > bottomCollisionY) {
-                        bottomCollisionY = pixelTop;
-                    }
-                }
+        hits->top = true;
+        if (hits->topY == 0 || pixelBottom < hits->topY) {
+            hits->topY = pixelBottom;
+        }
+    }
 
-                // Top collision (player hitting head on pixel)
-                else if (g_playerVY > 0 && // Moving upward
-                         playerTop >= pixelBottom &&
-                         playerTop <= pixelBottom + 5 &&
-                         playerRight > pixelScreenX &&
-                         playerLeft < pixelScreenX + pixelSize) {
-
-                    collideTop = true;
-                    if (topCollisionY == 0 || pixelBottom < topCollisionY) {
-                        topCollisionY = pixelBottom;
-                    }
-                }
+    // Calculate pixel height relative to player's bottom
+    int pixelHeightAbovePlayerFeet = pixelTop - box->bottom;
 
-                // Calculate pixel height relative to player's bottom
-                int pixelHeightAbovePlayerFeet = pixelTop - playerBottom;
-
-                // Right collision (player moving right into pixel)
-                if (g_playerVX > 0 &&
-                    playerRight >= pixelScreenX &&
-                    playerRight <= pixelScreenX + 5 &&
-                    playerBottom < pixelTop &&
-                    playerTop > pixelBottom &&
-                    pixelHeightAbovePlayerFeet >= horizontalCollisionHeightThreshold) {
-
-                    collideRight = true;
-                    if (rightCollisionX == 0 || pixelScreenX < rightCollisionX) {
-                        rightCollisionX = pixelScreenX;
-                    }
-                }
+    // Right collision (player moving right into pixel)
+    if (g_playerVX > 0 &&
+        box->right >= pixelScreenX &&
+        box->right <= pixelScreenX + 5 &&
+        box->bottom < pixelTop &&
+        box->top > pixelBottom &&
+        pixelHeightAbovePlayerFeet >= horizontalCollisionHeightThreshold) {
 
-                // Left collision (player moving left into pixel)
-                else if (g_playerVX < 0 &&
-                         playerLeft <= pixelScreenX + pixelSize &&
-                         playerLeft >= pixelScreenX + pixelSize - 5 &&
-                         playerBottom < pixelTop &&
-                         playerTop > pixelBottom &&
-                         pixelHeightAbovePlayerFeet >= horizontalCollisionHeightThreshold) {
-
-                    collideLeft = true;
-                    if (leftCollisionX == 0 || pixelScreenX + pixelSize > leftCollisionX) {
-                        leftCollisionX = pixelScreenX+2;
-                    }
-                }
-            }
+        hits->right = true;
+        if (hits->rightX == 0 || pixelScreenX < hits->rightX) {
+            hits->rightX = pixelScreenX;
+        }
+    }
+
+    // Left collision (player moving left into pixel)
+    else if (g_playerVX < 0 &&
+             box->left <= pixelScreenX + pixelSize &&
+             box->left >= pixelScreenX + pixelSize - 5 &&
+             box->bottom < pixelTop &&
+             box->top > pixelBottom &&
+             pixelHeightAbovePlayerFeet >= horizontalCollisionHeightThreshold) {
+
+        hits->left = true;
+        if (hits->leftX == 0 || pixelScreenX + pixelSize > hits->leftX) {
+            hits->leftX = pixelScreenX+2;
         }
     }
+}
 
+static void ResolveCollisionHits(const PlayerBox *box, const CollisionHits *hits)
+{
     // FIXED: Resolve collisions with improved ground state management
 
     // Bottom collision - player is on top of a platform
-    if (collideBottom) {
+    if (hits->bottom) {
         // Apply the offset when setting the player's position
-        g_playerY = bottomCollisionY + collisionBoxOffset;
+        g_playerY = hits->bottomY + box->offset;
         g_playerVY = 0;
         g_isOnGround = true;
 
@@ -281,29 +283,111 @@ static void CheckBitmapCollision(int bitmapX, int bitmapY, const uint8_t *bitmap
     else{
         g_isOnGround = false;
     }
-    // NOTE: Removed the else clause that was immediately setting g_isOnGround to false
-    // This allows the ground state to persist between frames
 
     // Top collision - player hits head
-    if (collideTop) {
+    if (hits->top) {
         // Apply the offset when setting the player's position
-        g_playerY = topCollisionY - playerHeight + collisionBoxOffset;
+        g_playerY = hits->topY - box->height + box->offset;
         g_playerVY = 0;
     }
 
     // Right collision - player hits wall on right
-    if (collideRight) {
-        g_playerX = rightCollisionX - playerWidth;
+    if (hits->right) {
+        g_playerX = hits->rightX - box->width;
         g_playerVX = 0;
     }
 
     // Left collision - player hits wall on left
-    else if (collideLeft) {
-        g_playerX = leftCollisionX;
+    else if (hits->left) {
+        g_playerX = hits->leftX;
         g_playerVX = 0;
     }
 }
 
+//*****************************************************************************
+// Check the player against the current level's collision data. Only pixels
+// within the collision tolerances of the player box can register a contact:
+// x from left - 1 (or right - 5) to right (or left + 4), y from bottom - 6
+// up to top or bottom + 7. The surface heights and tile grid rule most of
+// those windows out at once, the row runs list the solid pixels in the
+// rest. Pixels are visited in the same order as a full scan of the map (top
+// row first, left to right), so the contacts found are identical.
+//*****************************************************************************
+static void CheckLevelCollision(void)
+{
+    PlayerBox box;
+    CollisionHits hits = {false, false, false, false, 0, 0, 0, 0};
+    int minX, maxX, minY, maxY, y, r, x;
+
+    GetPlayerBox(&box);
+
+    // Early exit if no bounding box intersection with the map is possible
+    if (box.right < 0 || box.left > LEVEL_COLLISION_WIDTH ||
+        box.bottom > LEVEL_COLLISION_HEIGHT || box.top < 0) {
+        return;
+    }
+
+    minX = (box.left - 1 < box.right - 5) ? box.left - 1 : box.right - 5;
+    maxX = (box.right > box.left + 4) ? box.right : box.left + 4;
+    minY = box.bottom - 6;
+    maxY = (box.top > box.bottom + 7) ? box.top : box.bottom + 7;
+
+    // Airborne above everything in these columns, or no solid tile nearby
+    if (LevelCollision_SurfaceHeight(minX, maxX) > minY &&
+        LevelCollision_AnySolid(minX, minY, maxX, maxY)) {
+        for (y = maxY; y >= minY; y--) {
+            const LevelRun* runs;
+            int count = LevelCollision_GetRuns(y, &runs);
+
+            for (r = 0; r < count && runs[r].start <= maxX; r++) {
+                int start = (runs[r].start > minX) ? runs[r].start : minX;
+                int end = (runs[r].end < maxX) ? runs[r].end : maxX;
+
+                for (x = start; x <= end; x++) {
+                    TestCollisionPixel(&box, x, y, 1, &hits);
+                }
+            }
+        }
+    }
+
+    ResolveCollisionHits(&box, &hits);
+}
+
+#if VIDEO_GAME_COLLISION_BENCHMARK
+//*****************************************************************************
+// Reference: test every solid pixel of the bitmap, as before the collision
+// data existed
+//*****************************************************************************
+static void CheckBitmapCollision(int bitmapX, int bitmapY, const uint8_t *bitmap,
+                                int width, int height, int pixelSize)
+{
+    PlayerBox box;
+    CollisionHits hits = {false, false, false, false, 0, 0, 0, 0};
+    int byteWidth = (width + 7) / 8; // Bytes per row in bitmap
+    int i, j;
+
+    GetPlayerBox(&box);
+
+    // Early exit if no bounding box intersection is possible
+    if (box.right < bitmapX || box.left > bitmapX + width * pixelSize ||
+        box.bottom > bitmapY + height * pixelSize || box.top < bitmapY) {
+        return;
+    }
+
+    for (j = 0; j < height; j++) {
+        for (i = 0; i < width; i++) {
+            if (bitmap[j * byteWidth + i / 8] & (0x80 >> (i & 7))) {
+                // Invert Y coordinate to match screen coordinates
+                TestCollisionPixel(&box, bitmapX + i * pixelSize,
+                                   bitmapY + (height - 1 - j) * pixelSize, pixelSize, &hits);
+            }
+        }
+    }
+
+    ResolveCollisionHits(&box, &hits);
+}
+#endif
+
 //*****************************************************************************
 // Killbox definitions
 // ****************************************************************************
@@ -622,8 +706,9 @@ static void DrawEnemies(void) {
 
 //*****************************************************************************
 // Update player physics based on input and environment
+// Returns true if the level was restarted or changed
 //*****************************************************************************
-static void UpdatePlayerPhysics(void)
+static bool UpdatePlayerPhysics(void)
 {
     float voltage_59, voltage_60;
     bool jumpButtonPressed = IsJumpButtonPressed();
@@ -684,7 +769,7 @@ static void UpdatePlayerPhysics(void)
         // Player hit an enemy - reset like killbox/falling off map
         g_firstFrame = true;
         VideoGame_Initialize();
-        return;
+        return true;
     }
 
     // Check killbox entry - if hit, reset the player
@@ -692,27 +777,18 @@ static void UpdatePlayerPhysics(void)
         // Player hit a killbox - reset like falling off map
         g_firstFrame = true;
         VideoGame_Initialize();
-        return;
+        return true;
     }
 
     // Check door entry - if entered a door, return early to let map change take effect
     if (CheckDoorEntry()) {
         // Door entered, map changed - reinitialize the game with the new map
         VideoGame_Initialize();
-        return;
+        return true;
      }
 
-    // Check collision with the level bitmap
-    const uint8_t* levelBitmap = get_map_frame(g_currentMapFrame);
-    static int levelWidth = 128;
-    static int levelHeight = 128;
-    static int levelX = 0;
-    static int levelY = 0;
-
-    // If levelBitmap is set, check collisions with it
-    if (levelBitmap != NULL) {
-        CheckBitmapCollision(levelX, levelY, levelBitmap, levelWidth, levelHeight, 1);
-    }
+    // Check collision with the level, using the data built when it loaded
+    CheckLevelCollision();
 
     // Boundary detection for left/right (fallback collision)
     if (g_playerX < 0) {
@@ -727,7 +803,7 @@ static void UpdatePlayerPhysics(void)
     if (g_playerY < 0) {
         g_firstFrame = true;
         VideoGame_Initialize();
-        return;
+        return true;
     }
 
     // Ceiling collision
@@ -735,6 +811,8 @@ static void UpdatePlayerPhysics(void)
         g_playerY = SCREEN_HEIGHT;
         g_playerVY = 0;
     }
+
+    return false;
 }
 
 
@@ -750,6 +828,9 @@ void VideoGame_Initialize(void)
     const uint8_t* levelBitmap = get_map_frame(g_currentMapFrame);
     drawBitmap(0, 0, levelBitmap, 128, 128, WHITE, 1, false, BLACK);
 
+    // Collision data for the physics steps, so they never read the map file
+    LevelCollision_Build(levelBitmap, MAP_WIDTH, MAP_HEIGHT);
+
     // Clear and set up doors for the current map
     ClearDoors();
 
@@ -846,6 +927,14 @@ void VideoGame_Initialize(void)
     playing_jump_animation = false;
     playing_double_jump_animation = false;
     double_jump_available = true;
+
+    // Loading the level took a while; don't simulate it
+    if (!g_loopStarted) {
+        GameLoop_Init(&g_loop, PHYSICS_STEP_HZ, MAX_STEPS_PER_FRAME);
+        g_loopStarted = true;
+    } else {
+        GameLoop_Resync(&g_loop);
+    }
 }
 
 //*****************************************************************************
@@ -940,11 +1029,15 @@ static void DrawCharacter(int x, int y, const uint8_t* bitmap, uint16_t color, b
 }
 
 //*****************************************************************************
-// Run one frame of the video game
+// Run one frame of the video game: the physics steps due since the last
+// frame, then one render
 //*****************************************************************************
 bool VideoGame_RunFrame(void)
 {
     bool debugview = false;
+    const uint8_t* character_bitmap;
+    int steps, step;
+
     // Check if button 2 is pressed to exit
     if(ShouldExit()) {
         g_firstFrame = true;
@@ -955,13 +1048,27 @@ bool VideoGame_RunFrame(void)
         VideoGame_Initialize();
     }
 
-    // Update player physics
-    UpdatePlayerPhysics();
+    // Nothing moved if the frame was shorter than a step
+    steps = GameLoop_StepsDue(&g_loop);
+    if (steps == 0 && !g_firstFrame) {
+        return true;
+    }
 
+    for (step = 0; step < steps; step++) {
+        // Update player physics; a restart or door resyncs the loop, so
+        // the rest of this frame's steps belong to the old level
+        if (UpdatePlayerPhysics()) {
+            break;
+        }
 
+        // Update enemy physics and AI
+        UpdateEnemyPhysics();
 
-    // Update enemy physics and AI
-    UpdateEnemyPhysics();
+        // Animations advance per step, like the physics
+        UpdateEnemyAnimations();
+        UpdateCharacterAnimation(g_playerVX, g_isOnGround, &playing_jump_animation,
+                                 &playing_double_jump_animation, &character_Frame);
+    }
 
     // Check if player has fallen off screen
     if (g_firstFrame && g_playerY < 0) {
@@ -985,30 +1092,21 @@ bool VideoGame_RunFrame(void)
     }
     }
 
-
-    // Update enemy animations
-    UpdateEnemyAnimations();
     // Draw enemies
-     DrawEnemies();
-
-    // Get the appropriate character bitmap based on state
-    const uint8_t* character_bitmap = SelectCharacterBitmap(g_playerVX, playing_jump_animation,
-                                                               playing_double_jump_animation, character_Frame);
+    DrawEnemies();
 
-    // Erase previous player position if not first frame
+    // Erase previous player position if not first frame, with the bitmap it was drawn with
     if (!g_firstFrame) {
-        DrawCharacter((int)g_prevPlayerX, (int)g_prevPlayerY, character_bitmap, BLACK, true, BLACK);
+        character_bitmap = SelectCharacterBitmap(g_prevPlayerVX, g_prevJumpAnimation,
+                                                 g_prevDoubleJumpAnimation, g_prevCharacterFrame);
+        DrawCharacter(g_prevPlayerX, g_prevPlayerY, character_bitmap, BLACK, true, BLACK);
     } else {
         g_firstFrame = false;
     }
 
-    // Update character animation state
-    UpdateCharacterAnimation(g_playerVX, g_isOnGround, &playing_jump_animation,
-                                &playing_double_jump_animation, &character_Frame);
-
-    // Get the updated character bitmap after animation update
+    // Get the character bitmap for the current state
     character_bitmap = SelectCharacterBitmap(g_playerVX, playing_jump_animation,
-                                                playing_double_jump_animation, character_Frame);
+                                             playing_double_jump_animation, character_Frame);
 
     // Draw player
     if(g_isOnGround){
@@ -1018,10 +1116,111 @@ bool VideoGame_RunFrame(void)
         DrawCharacter((int)g_playerX, (int)g_playerY, character_bitmap, PLAYER_COLOR, false, BLACK);
     }
 
-    // Save current position for next frame
+    // Save current position and animation state for next frame
     g_prevPlayerX = (int)g_playerX;
     g_prevPlayerY = (int)g_playerY;
-
+    g_prevPlayerVX = g_playerVX;
+    g_prevCharacterFrame = character_Frame;
+    g_prevJumpAnimation = playing_jump_animation;
+    g_prevDoubleJumpAnimation = playing_double_jump_animation;
 
     return true;
 }
+
+//*****************************************************************************
+// Frame timing of the fixed-timestep loop
+//*****************************************************************************
+void VideoGame_GetFrameStats(unsigned long* frameTimeUs, unsigned long* steps,
+                             unsigned long* droppedSteps)
+{
+    *frameTimeUs = GameLoop_FrameTimeUs(&g_loop);
+    *steps = g_loop.steps;
+    *droppedSteps = g_loop.droppedSteps;
+}
+
+#if VIDEO_GAME_COLLISION_BENCHMARK
+//*****************************************************************************
+// Collision benchmark
+// Each trace point runs from the same player state through both collision
+// routines. SysTick counts down at 80MHz; a full-map scan fits its range.
+//*****************************************************************************
+#define BENCH_TRACE_STEPS       64
+
+typedef struct {
+    float x, y, vx, vy;
+    bool onGround;
+} BenchPlayerState;
+
+static void BenchSetPlayer(const BenchPlayerState *state)
+{
+    g_playerX = state->x;
+    g_playerY = state->y;
+    g_playerVX = state->vx;
+    g_playerVY = state->vy;
+    g_isOnGround = state->onGround;
+}
+
+static void BenchGetPlayer(BenchPlayerState *state)
+{
+    state->x = g_playerX;
+    state->y = g_playerY;
+    state->vx = g_playerVX;
+    state->vy = g_playerVY;
+    state->onGround = g_isOnGround;
+}
+
+void VideoGame_CollisionBenchmark(void)
+{
+    unsigned long scanTicks = 0, dataTicks = 0, start;
+    int mismatches = 0, checks = 0;
+    int map, step;
+
+    SysTickDisable();
+    SysTickIntDisable();
+    SysTickPeriodSet(0xFFFFFF);
+    SysTickEnable();
+
+    for (map = 0; map < MAP_FRAME_COUNT; map++) {
+        const uint8_t* levelBitmap = get_map_frame(map);
+
+        LevelCollision_Build(levelBitmap, MAP_WIDTH, MAP_HEIGHT);
+
+        for (step = 0; step < BENCH_TRACE_STEPS; step++) {
+            // A run across the map, bouncing up and down through the platforms
+            BenchPlayerState trace, scanResult, dataResult;
+
+            trace.x = 2.0f + step * 1.8f;
+            trace.y = 20.0f + (step * 37) % 100;
+            trace.vx = (step & 1) ? 2.5f : -2.5f;
+            trace.vy = (step & 2) ? 3.0f : -3.0f;
+            trace.onGround = (step & 4) != 0;
+
+            BenchSetPlayer(&trace);
+            start = SysTickValueGet();
+            CheckBitmapCollision(0, 0, levelBitmap, MAP_WIDTH, MAP_HEIGHT, 1);
+            scanTicks += (start - SysTickValueGet()) & 0xFFFFFF;
+            BenchGetPlayer(&scanResult);
+
+            BenchSetPlayer(&trace);
+            start = SysTickValueGet();
+            CheckLevelCollision();
+            dataTicks += (start - SysTickValueGet()) & 0xFFFFFF;
+            BenchGetPlayer(&dataResult);
+
+            if (scanResult.x != dataResult.x || scanResult.y != dataResult.y ||
+                scanResult.vx != dataResult.vx || scanResult.vy != dataResult.vy ||
+                scanResult.onGround != dataResult.onGround) {
+                mismatches++;
+            }
+            checks++;
+        }
+    }
+
+    Report("Full map scan: %lu cycles/check\n\r", scanTicks / checks);
+    Report("Collision data: %lu cycles/check\n\r", dataTicks / checks);
+    Report("%d of %d checks disagree\n\r", mismatches, checks);
+
+    // The benchmark left the player and collision data on the last map
+    g_firstFrame = true;
+}
+#endif // VIDEO_GAME_COLLISION_BENCHMARK
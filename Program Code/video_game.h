@@ -6,6 +6,11 @@
 #ifndef VIDEO_GAME_H
 #define VIDEO_GAME_H
 
+// Set to 1 to build VideoGame_CollisionBenchmark()
+#ifndef VIDEO_GAME_COLLISION_BENCHMARK
+#define VIDEO_GAME_COLLISION_BENCHMARK 0
+#endif
+
 // Initialize the video game
 void VideoGame_Initialize(void);
 
@@ -13,7 +18,19 @@ void VideoGame_Initialize(void);
 // Returns: true to continue running, false to exit
 bool VideoGame_RunFrame(void);
 
+// Fixed-timestep loop statistics: length of the last frame in microseconds,
+// physics steps run and steps dropped because a frame ran too long
+void VideoGame_GetFrameStats(unsigned long* frameTimeUs, unsigned long* steps,
+                             unsigned long* droppedSteps);
+
 // Clean up resources before exiting
 void VideoGame_Cleanup(void);
 
+#if VIDEO_GAME_COLLISION_BENCHMARK
+// Replay a movement trace over every map through the old full-map collision
+// scan and the precomputed collision data, check they agree and print the
+// cycles per check over UART. The game restarts on its next frame.
+void VideoGame_CollisionBenchmark(void);
+#endif
+
 #endif // VIDEO_GAME_H